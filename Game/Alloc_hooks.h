@@ -0,0 +1,85 @@
+#pragma once
+#include <new>
+
+#include "Alloc_stats.h"
+
+// Замена глобальных operator new/delete для учета выделений (Alloc_stats)
+// Подключается ровно в одну единицу трансляции - main.cpp; пока учет выключен, выделение стоит
+// одной проверки флага сверх malloc/free
+
+// free_hooked не встраивается: иначе после встраивания замененного operator delete в вызывающий код
+// GCC видит пару new/free и выдает -Wmismatched-new-delete
+#if defined(_MSC_VER)
+#define ALLOC_NOINLINE __declspec(noinline)
+#else
+#define ALLOC_NOINLINE __attribute__((noinline))
+#endif
+
+inline void* alloc_hooked(size_t size)
+{
+    void* ptr = malloc(size ? size : 1);
+    if (ptr && Alloc_stats::enabled())
+        Alloc_stats::on_alloc(size, Alloc_stats::usable_size(ptr));
+    return ptr;
+}
+
+ALLOC_NOINLINE inline void free_hooked(void* ptr) noexcept
+{
+    if (ptr && Alloc_stats::enabled())
+        Alloc_stats::on_free(Alloc_stats::usable_size(ptr));
+    free(ptr);
+}
+
+void* operator new(size_t size)
+{
+    if (void* ptr = alloc_hooked(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    if (void* ptr = alloc_hooked(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return alloc_hooked(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return alloc_hooked(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free_hooked(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free_hooked(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free_hooked(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    free_hooked(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    free_hooked(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    free_hooked(ptr);
+}
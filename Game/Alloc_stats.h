@@ -0,0 +1,189 @@
+#pragma once
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX  // min/max из windows.h мешают std::min/std::max
+#endif
+#ifndef NOGDI
+#define NOGDI  // Макрос ERROR из wingdi.h совпадает с Log_level::ERROR
+#endif
+#include <malloc.h>
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#include <sys/resource.h>
+#else
+#include <malloc.h>
+#include <sys/resource.h>
+#endif
+
+#include <nlohmann/json.hpp>
+
+using namespace std;
+
+// Подсистемы, по которым учитываются выделения памяти
+enum class alloc_subsystem
+{
+    OTHER,      // Все остальное (настройки, журнал, запуск)
+    SEARCH,     // Поиск хода бота (Logic::find_best_turns)
+    HISTORY,    // Журнал ходов доски (Board::add_history)
+    RENDERING,  // Отрисовка в окне и в PNG
+    COUNT
+};
+
+// Структура alloc_counters - выделения памяти за интервал (разность двух снимков)
+struct alloc_counters
+{
+    uint64_t allocations = 0;  // Количество вызовов operator new
+    uint64_t bytes = 0;        // Запрошено байт
+
+    alloc_counters operator-(const alloc_counters& other) const
+    {
+        return { allocations - other.allocations, bytes - other.bytes };
+    }
+};
+
+// Структура alloc_counter - счетчики подсистемы, общие для всех потоков
+struct alloc_counter
+{
+    atomic<uint64_t> allocations{ 0 };
+    atomic<uint64_t> bytes{ 0 };
+};
+
+// Класс Alloc_stats - учет выделений памяти по подсистемам (включается режимом "alloc" бенчмарка и матча
+// или настройкой Log/AllocStats). Выделения считает замененный operator new (Alloc_hooks.h), подсистему
+// задает alloc_scope текущего потока. Выключенный учет стоит одной проверки флага на выделение
+class Alloc_stats
+{
+public:
+    static void enable()
+    {
+        is_enabled.store(true, memory_order_release);
+    }
+
+    static bool enabled()
+    {
+        return is_enabled.load(memory_order_relaxed);
+    }
+
+    // Подсистема текущего потока
+    static alloc_subsystem& current()
+    {
+        thread_local alloc_subsystem subsystem = alloc_subsystem::OTHER;
+        return subsystem;
+    }
+
+    // Учитывает выделение size байт (usable - фактический размер блока в куче)
+    static void on_alloc(const size_t size, const size_t usable)
+    {
+        alloc_counter& c = counters[size_t(current())];
+        c.allocations.fetch_add(1, memory_order_relaxed);
+        c.bytes.fetch_add(size, memory_order_relaxed);
+        const int64_t live = live_bytes.fetch_add(int64_t(usable), memory_order_relaxed) + int64_t(usable);
+        int64_t peak = peak_live_bytes.load(memory_order_relaxed);
+        while (live > peak && !peak_live_bytes.compare_exchange_weak(peak, live, memory_order_relaxed))
+        {
+        }
+    }
+
+    static void on_free(const size_t usable)
+    {
+        live_bytes.fetch_sub(int64_t(usable), memory_order_relaxed);
+    }
+
+    // Снимок счетчиков подсистемы (интервал - разность снимков)
+    static alloc_counters snapshot(const alloc_subsystem subsystem)
+    {
+        const alloc_counter& c = counters[size_t(subsystem)];
+        return { c.allocations.load(memory_order_relaxed), c.bytes.load(memory_order_relaxed) };
+    }
+
+    // Наибольший объем кучи, занятой после включения учета
+    static int64_t peak_heap()
+    {
+        return peak_live_bytes.load(memory_order_relaxed);
+    }
+
+    // Пиковый резидентный размер процесса в байтах (0 - неизвестен)
+    static uint64_t peak_rss()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS pmc;
+        return GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) ? uint64_t(pmc.PeakWorkingSetSize) : 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+#ifdef __APPLE__
+        return uint64_t(usage.ru_maxrss);  // В байтах
+#else
+        return uint64_t(usage.ru_maxrss) * 1024;  // В килобайтах
+#endif
+#endif
+    }
+
+    // Фактический размер блока кучи
+    static size_t usable_size(void* ptr)
+    {
+#ifdef _WIN32
+        return _msize(ptr);
+#elif defined(__APPLE__)
+        return malloc_size(ptr);
+#else
+        return malloc_usable_size(ptr);
+#endif
+    }
+
+    static const char* name(const alloc_subsystem subsystem)
+    {
+        static const char* names[] = { "other", "search", "history", "rendering" };
+        return names[size_t(subsystem)];
+    }
+
+    // Разбивка по подсистемам: выделения и байты с начала учета, пик кучи и пик RSS
+    static nlohmann::json to_json()
+    {
+        nlohmann::json res;
+        for (size_t i = 0; i < size_t(alloc_subsystem::COUNT); ++i)
+        {
+            const alloc_counters c = snapshot(alloc_subsystem(i));
+            res[name(alloc_subsystem(i))] = { { "allocations", c.allocations }, { "bytes", c.bytes } };
+        }
+        res["peak_heap_bytes"] = peak_heap();
+        res["peak_rss_bytes"] = peak_rss();
+        return res;
+    }
+
+private:
+    static inline atomic<bool> is_enabled{ false };
+    static inline alloc_counter counters[size_t(alloc_subsystem::COUNT)];
+    static inline atomic<int64_t> live_bytes{ 0 };
+    static inline atomic<int64_t> peak_live_bytes{ 0 };
+};
+
+// Класс alloc_scope задает подсистему для выделений текущего потока до конца области видимости
+class alloc_scope
+{
+public:
+    explicit alloc_scope(const alloc_subsystem subsystem) : saved(Alloc_stats::current())
+    {
+        Alloc_stats::current() = subsystem;
+    }
+
+    ~alloc_scope()
+    {
+        Alloc_stats::current() = saved;
+    }
+
+    alloc_scope(const alloc_scope&) = delete;
+    alloc_scope& operator=(const alloc_scope&) = delete;
+
+private:
+    alloc_subsystem saved;
+};
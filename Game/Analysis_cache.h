@@ -0,0 +1,329 @@
+#pragma once
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX  // min/max из windows.h мешают std::min/std::max
+#endif
+#ifndef NOGDI
+#define NOGDI  // Макрос ERROR из wingdi.h совпадает с Log_level::ERROR
+#endif
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../Models/Cache_record.h"
+#include "Logger.h"
+
+using namespace std;
+
+// Класс Analysis_cache - постоянный кэш результатов глубокого поиска, общий для всех Logic процесса
+// Файл отображается в память и только дописывается: запись сначала заполняется, контрольная сумма
+// ставится последней, поэтому оборванная при сбое запись при открытии просто отбрасывается.
+// Устаревшие записи (замененные более новыми с тем же ключом) удаляются сжатием при открытии:
+// живые записи пишутся во временный файл, который атомарно переименовывается поверх старого
+class Analysis_cache
+{
+public:
+    // Возвращает кэш для файла path (открывается при первом обращении)
+    // nullptr, если файл недоступен или уже открыт другим процессом
+    static Analysis_cache* open(const string& path)
+    {
+        static mutex caches_mutex;
+        static map<string, unique_ptr<Analysis_cache>> caches;
+        lock_guard<mutex> lock(caches_mutex);
+        auto it = caches.find(path);
+        if (it == caches.end())
+        {
+            unique_ptr<Analysis_cache> cache(new Analysis_cache(path));
+            if (!cache->data)
+                cache.reset();
+            it = caches.emplace(path, move(cache)).first;
+        }
+        return it->second.get();
+    }
+
+    // Ищет запись по ключу; возвращает true и копию записи, если она есть
+    bool find(const uint64_t key, cache_record& rec)
+    {
+        lock_guard<mutex> lock(cache_mutex);
+        if (!data)
+            return false;
+        auto it = index.find(key);
+        if (it == index.end())
+            return false;
+        rec = records()[it->second];
+        return true;
+    }
+
+    // Дописывает запись в конец файла (контрольная сумма вычисляется здесь)
+    void store(cache_record rec)
+    {
+        lock_guard<mutex> lock(cache_mutex);
+        if (!data)
+            return;
+        if (count == capacity && !map_file(capacity + GROW_RECORDS))
+        {
+            // Без отображения кэш дальше не используется; записанное остается в файле
+            index.clear();
+            count = 0;
+            return;
+        }
+        rec.checksum = 0;
+        cache_record& slot = records()[count];
+        slot = rec;
+        slot.checksum = rec.calc_checksum();  // Запись становится видимой при следующем открытии только целиком
+        index[rec.key] = count++;
+    }
+
+    // Количество различных позиций в кэше
+    size_t size()
+    {
+        lock_guard<mutex> lock(cache_mutex);
+        return index.size();
+    }
+
+    ~Analysis_cache()
+    {
+        unmap_file();
+        close_file();
+    }
+
+private:
+    // Заголовок файла
+    struct file_header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+    };
+
+    static constexpr uint32_t VERSION = 2;
+    static constexpr size_t GROW_RECORDS = 4096;  // На сколько записей увеличивается файл
+
+    explicit Analysis_cache(const string& path) : path(path)
+    {
+        if (!open_file())
+        {
+            Logger::get().warning("Analysis cache is not available", { { "file", path.c_str() } });
+            return;
+        }
+        if (!load())
+        {
+            Logger::get().warning("Analysis cache has wrong format", { { "file", path.c_str() } });
+            unmap_file();
+            close_file();
+            return;
+        }
+        // Сжимаем файл, если больше половины записей устарели
+        if (count > 2 * index.size() + GROW_RECORDS)
+            compact();
+        Logger::get().info("Analysis cache loaded",
+            { { "file", path.c_str() }, { "positions", index.size() }, { "records", count } });
+    }
+
+    // Отображает файл и строит индекс по действительным записям
+    bool load()
+    {
+        const size_t file_size = get_file_size();
+        const bool is_new = file_size < sizeof(file_header);
+        size_t records_num = is_new ? GROW_RECORDS : (file_size - sizeof(file_header)) / sizeof(cache_record);
+        if (!map_file(max(records_num, size_t(1))))
+            return false;
+
+        file_header& header = *reinterpret_cast<file_header*>(data);
+        const file_header expected{ { 'C', 'H', 'K', 'C', 'A', 'C', 'H', 'E' }, VERSION, sizeof(cache_record) };
+        if (is_new)
+            header = expected;
+        else if (memcmp(&header, &expected, sizeof(file_header)) != 0)
+            return false;
+
+        // Записи идут подряд; первая недействительная - конец журнала (пустое место или оборванная запись)
+        index.clear();
+        count = 0;
+        while (count < capacity && records()[count].is_valid())
+        {
+            index[records()[count].key] = count;
+            ++count;
+        }
+        return true;
+    }
+
+    // Переписывает только живые записи во временный файл и заменяет им основной
+    void compact()
+    {
+        vector<uint32_t> live;
+        live.reserve(index.size());
+        for (const auto& it : index)
+            live.push_back(it.second);
+        sort(live.begin(), live.end());
+
+        const string tmp_path = path + ".tmp";
+        FILE* fout = fopen(tmp_path.c_str(), "wb");
+        if (!fout)
+            return;
+        bool ok = fwrite(data, sizeof(file_header), 1, fout) == 1;
+        for (const uint32_t i : live)
+            ok = ok && fwrite(&records()[i], sizeof(cache_record), 1, fout) == 1;
+        ok = ok && fflush(fout) == 0;
+#ifdef _WIN32
+        ok = ok && _commit(_fileno(fout)) == 0;
+#else
+        ok = ok && fsync(fileno(fout)) == 0;
+#endif
+        fclose(fout);
+        if (!ok)
+        {
+            remove(tmp_path.c_str());
+            return;
+        }
+
+        // До переименования основной файл не меняется, поэтому сбой на любом шаге ничего не теряет
+        unmap_file();
+        close_file();
+#ifdef _WIN32
+        const bool renamed = MoveFileExA(tmp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+        const bool renamed = rename(tmp_path.c_str(), path.c_str()) == 0;
+#endif
+        if (!renamed)
+            remove(tmp_path.c_str());
+        if (!open_file() || !load())
+        {
+            unmap_file();
+            close_file();
+        }
+    }
+
+    cache_record* records() const
+    {
+        return reinterpret_cast<cache_record*>(data + sizeof(file_header));
+    }
+
+#ifdef _WIN32
+    // Файл открывается без совместного доступа: второй процесс работает без кэша
+    bool open_file()
+    {
+        file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+            nullptr);
+        return file != INVALID_HANDLE_VALUE;
+    }
+
+    size_t get_file_size() const
+    {
+        LARGE_INTEGER size;
+        return GetFileSizeEx(file, &size) ? size_t(size.QuadPart) : 0;
+    }
+
+    // Отображает файл вместимостью records_num записей (увеличивая его при необходимости)
+    bool map_file(const size_t records_num)
+    {
+        unmap_file();
+        const size_t bytes = sizeof(file_header) + records_num * sizeof(cache_record);
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, DWORD(uint64_t(bytes) >> 32), DWORD(bytes), nullptr);
+        if (!mapping)
+            return false;
+        data = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes));
+        capacity = data ? records_num : 0;
+        return data != nullptr;
+    }
+
+    void unmap_file()
+    {
+        if (data)
+        {
+            FlushViewOfFile(data, 0);
+            UnmapViewOfFile(data);
+        }
+        if (mapping)
+            CloseHandle(mapping);
+        data = nullptr;
+        mapping = nullptr;
+        capacity = 0;
+    }
+
+    void close_file()
+    {
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+    }
+
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    // Файл блокируется целиком: второй процесс работает без кэша
+    bool open_file()
+    {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd >= 0 && flock(fd, LOCK_EX | LOCK_NB) != 0)
+            close_file();
+        return fd >= 0;
+    }
+
+    size_t get_file_size() const
+    {
+        struct stat st;
+        return fstat(fd, &st) == 0 ? size_t(st.st_size) : 0;
+    }
+
+    // Отображает файл вместимостью records_num записей (увеличивая его при необходимости)
+    bool map_file(const size_t records_num)
+    {
+        unmap_file();
+        const size_t bytes = sizeof(file_header) + records_num * sizeof(cache_record);
+        if (get_file_size() < bytes && ftruncate(fd, off_t(bytes)) != 0)
+            return false;
+        void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (ptr == MAP_FAILED)
+            return false;
+        data = static_cast<char*>(ptr);
+        mapped_bytes = bytes;
+        capacity = records_num;
+        return true;
+    }
+
+    void unmap_file()
+    {
+        if (data)
+        {
+            msync(data, mapped_bytes, MS_SYNC);
+            munmap(data, mapped_bytes);
+        }
+        data = nullptr;
+        mapped_bytes = 0;
+        capacity = 0;
+    }
+
+    void close_file()
+    {
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+    }
+
+    int fd = -1;
+    size_t mapped_bytes = 0;
+#endif
+
+    string path;
+    mutex cache_mutex;                          // Кэш общий для потоков поиска сервера
+    char* data = nullptr;                       // Отображение файла: заголовок и записи
+    size_t capacity = 0;                        // Вместимость отображения в записях
+    uint32_t count = 0;                         // Количество записей в журнале
+    unordered_map<uint64_t, uint32_t> index;    // Ключ -> номер последней записи с этим ключом
+};
@@ -0,0 +1,195 @@
+#pragma once
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Alloc_stats.h"
+#include "Board.h"
+#include "Config.h"
+#include "Logic.h"
+
+// Структура bench_position - одна позиция бенчмарка
+struct bench_position
+{
+    // Позиция: 32 символа по игровым клеткам (dark_cell) сверху вниз
+    // '.' - пусто, 'w'/'b' - белая/черная шашка, 'W'/'B' - белая/черная дамка
+    const char* cells;
+    bool color;                // Кто ходит: false - белые, true - черные
+    int level;                 // Уровень бота (глубина поиска)
+    const char* scoring;       // BotScoringType
+    const char* optimization;  // Optimization
+};
+
+// Класс Bench - режим "bench": поиск на фиксированном наборе позиций с фиксированной глубиной
+// Суммарное количество узлов служит подписью поведения поиска: оно меняется только при изменении
+// самого поиска, а не при ускорении. Случайность выключена (NoRandom), поиск однопоточный
+// Режим "bench alloc" дополнительно считает выделения памяти каждого поиска и печатает разбивку по подсистемам
+class Bench
+{
+public:
+    explicit Bench(const bool alloc = false) : alloc(alloc)
+    {
+    }
+
+    // Запускает бенчмарк и печатает подпись, время и скорость (узлов в секунду)
+    int run()
+    {
+        if (alloc)
+            Alloc_stats::enable();
+        Config config;
+        config.set("Bot", "NoRandom", true);
+        config.set("Cache", "File", "");  // Результаты из кэша исказили бы подпись
+        config.set("Bot", "Engine", "Minimax");
+        config.set("FlightRecorder", "Searches", 0);
+
+        uint64_t total_nodes = 0;
+        double total_ms = 0;
+        size_t footprint = 0;
+        for (size_t i = 0; i < positions().size(); ++i)
+        {
+            const bench_position& pos = positions()[i];
+            config.set("Bot", "BotScoringType", pos.scoring);
+            config.set("Bot", "Optimization", pos.optimization);
+
+            Board board;
+            board.set_board(parse_position(pos.cells));
+            Logic logic(&board, &config);
+            logic.Max_depth = pos.level;
+
+            const alloc_counters before = Alloc_stats::snapshot(alloc_subsystem::SEARCH);
+            auto start = chrono::steady_clock::now();
+            logic.find_turns(pos.color);
+            logic.find_best_turns(pos.color);
+            const double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            const alloc_counters search = Alloc_stats::snapshot(alloc_subsystem::SEARCH) - before;
+
+            total_nodes += logic.nodes;
+            total_ms += ms;
+            footprint = max(footprint, logic.memory_footprint());
+            cout << "Position " << i + 1 << "/" << positions().size() << " level " << pos.level << " "
+                 << pos.scoring << " " << pos.optimization << ": " << logic.nodes << " nodes";
+            if (alloc)
+                cout << ", " << search.allocations << " allocations, " << search.bytes << " bytes";
+            cout << "\n";
+        }
+
+        cout << "===========================\n";
+        cout << "Total time (ms) : " << (long long)total_ms << "\n";
+        cout << "Nodes searched  : " << total_nodes << "\n";
+        cout << "Nodes/second    : " << (long long)(total_nodes * 1000 / max(total_ms, 1.0)) << endl;
+        if (alloc)
+        {
+            const alloc_counters search = Alloc_stats::snapshot(alloc_subsystem::SEARCH);
+            cout << "Allocs/search   : " << search.allocations / positions().size() << "\n";
+            cout << "Bytes/search    : " << search.bytes / positions().size() << "\n";
+            print_alloc_breakdown(footprint);
+        }
+        return 0;
+    }
+
+    // Режим "bench <файл>": повторяет медленный поиск из файла воспроизведения FlightRecorder с теми же
+    // настройками, позицией и генератором случайных чисел и сравнивает узлы и время с записанными
+    static int replay(const string& path)
+    {
+        ifstream fin(path);
+        json repro = json::parse(fin, nullptr, false);
+        if (repro.is_discarded() || !repro.contains("position") || !repro.contains("random"))
+        {
+            cerr << "Can't read repro file " << path << endl;
+            return 1;
+        }
+        Config config;
+        for (const auto& section : repro["settings"].items())
+        {
+            for (const auto& setting : section.value().items())
+                config.set(section.key(), setting.key(), setting.value());
+        }
+        config.set("Cache", "File", "");  // Ответ из кэша не повторил бы поиск
+        config.set("TreeDump", "File", "");
+        config.set("FlightRecorder", "Searches", 0);
+
+        const string cells = repro["position"];
+        const bool color = repro["color"] == "b";
+        const int level = repro["level"];
+        const uint64_t recorded_nodes = repro["nodes"];
+        const double recorded_ms = repro["ms"];
+        Board board;
+        Logic logic(&board, &config);
+        logic.Max_depth = level;
+        // Без истории партии поиск не увидел бы ничьих повторением, которые видел записанный поиск
+        if (repro.contains("history"))
+            logic.set_game_history(repro["history"].get<vector<uint64_t>>());
+        auto start = chrono::steady_clock::now();
+        const vector<move_pos> turns =
+            logic.replay_search(Logic::to_board(parse_position(cells)), color, Flight_recorder::parse_random(repro["random"]));
+        const double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        cout << "Position        : " << cells << " " << (color ? "b" : "w") << " level " << level << " "
+             << string(config("Bot", "Engine")) << " " << string(config("Bot", "Optimization")) << "\n";
+        cout << "Best move       :";
+        for (const move_pos& turn : turns)
+            cout << " " << int(turn.x) << int(turn.y) << int(turn.x2) << int(turn.y2);
+        cout << "\n";
+        cout << "Nodes searched  : " << logic.nodes << " (recorded " << recorded_nodes << ", "
+             << (logic.nodes == recorded_nodes ? "same" : "DIFFERENT") << ")\n";
+        cout << "Time (ms)       : " << (long long)ms << " (recorded " << (long long)recorded_ms << ")";
+        if (repro.value("stopped", false))
+            cout << ", recorded search was stopped by its time limit";
+        cout << endl;
+        return 0;
+    }
+
+    // Печатает выделения по подсистемам с начала учета, пик кучи и RSS и память движка (footprint)
+    static void print_alloc_breakdown(const size_t footprint)
+    {
+        cout << "Allocations by subsystem (count / bytes):\n";
+        for (size_t i = 0; i < size_t(alloc_subsystem::COUNT); ++i)
+        {
+            const alloc_counters c = Alloc_stats::snapshot(alloc_subsystem(i));
+            cout << "  " << Alloc_stats::name(alloc_subsystem(i)) << ": " << c.allocations << " / " << c.bytes << "\n";
+        }
+        cout << "Engine footprint: " << footprint << " bytes\n";
+        cout << "Peak heap       : " << Alloc_stats::peak_heap() << " bytes\n";
+        cout << "Peak RSS        : " << Alloc_stats::peak_rss() << " bytes" << endl;
+    }
+
+    // Переводит строку позиции в матрицу доски 8x8
+    static vector<vector<POS_T>> parse_position(const string& cells)
+    {
+        const string symbols = ".wbWB";
+        vector<vector<POS_T>> mtx(8, vector<POS_T>(8, 0));
+        for (POS_T cell = 0; cell < 32; ++cell)
+            mtx[dark_cell_x(cell)][dark_cell_y(cell)] = POS_T(symbols.find(cells[cell]));
+        return mtx;
+    }
+
+    // Набор позиций: покрывает все уровни бота от 0 до 12, оба режима оценки и все уровни оптимизации
+    static const vector<bench_position>& positions()
+    {
+        static const vector<bench_position> res = {
+            { "bbbbbbbbbbbb........wwwwwwwwwwww", false, 0, "NumberAndPotential", "O1" },
+            { "bbbbbbbb...b..w.b...w...wwwwwwww", false, 1, "NumberOnly", "O1" },
+            { "bbbbb.bbb......b....w.w..w.wwwww", true, 2, "NumberAndPotential", "O1" },
+            { "b.bbbb..bb.b......b.w.wwwwww.w..", false, 3, "NumberOnly", "O1" },
+            { "bbbbb.b..bbbb..b....wwwwwwwwwww.", true, 4, "NumberAndPotential", "O1" },
+            { "bbbbbbbbbbbb........wwwwwwwwwwww", false, 5, "NumberAndPotential", "O0" },
+            { "bbb.b.b...b.bb.....www..ww.wwww.", false, 5, "NumberOnly", "O1" },
+            { "b.b.bb..b.b....w....w...ww.w.w..", false, 6, "NumberAndPotential", "O1" },
+            { "bbb.b........b......wbb.w..wwww.", false, 7, "NumberOnly", "O1" },
+            { "W..........B....w.....b....B...W", true, 8, "NumberAndPotential", "O1" },
+            { "b...bb......wb...b..w...w..w.w..", false, 9, "NumberOnly", "O1" },
+            { "bbbbbbbbbbbb........wwwwwwwwwwww", false, 10, "NumberOnly", "O1" },
+            { ".b...b..b.b..b......ww...www..w.", true, 10, "NumberAndPotential", "O1" },
+            { "..W.....b..........bww........w.", false, 11, "NumberOnly", "O1" },
+            { "......b.bb...b..w.wbw.w..w....w.", false, 12, "NumberAndPotential", "O1" },
+            { "bbbbbbbbbbbb........wwwwwwwwwwww", false, 10, "NumberAndPotential", "O2" },
+            { "bbb.b.b...b.bb.....www..ww.wwww.", false, 12, "NumberOnly", "O2" },
+        };
+        return res;
+    }
+
+private:
+    bool alloc;  // Режим учета выделений памяти
+};
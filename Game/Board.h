@@ -1,10 +1,16 @@
 #pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
-#include <fstream>
 #include <vector>
 
+#include "../Models/History.h"
 #include "../Models/Move.h"
 #include "../Models/Project_path.h"
+#include "../Models/Ranked_turn.h"
+#include "../Models/Score.h"
+#include "../Models/Search_snapshot.h"
 
 #ifdef __APPLE__
 #include <SDL2/SDL.h>
@@ -14,6 +20,11 @@
 #include <SDL_image.h>
 #endif
 
+#include "Alloc_stats.h"
+#include "Input_log.h"
+#include "Logger.h"
+#include "Tracer.h"
+
 using namespace std;
 
 // Класс Board отвечает за графическое представление доски и управление игровым состоянием
@@ -62,6 +73,9 @@ public:
 
         // Создаем рендерер с аппаратным ускорением и вертикальной синхронизацией
         ren = SDL_CreateRenderer(win, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+        // Без видеокарты (драйвер "dummy" на машинах без экрана) - программная отрисовка
+        if (ren == nullptr)
+            ren = SDL_CreateRenderer(win, -1, SDL_RENDERER_SOFTWARE);
         if (ren == nullptr)
         {
             print_exception("SDL_CreateRenderer can't create renderer");
@@ -97,9 +111,10 @@ public:
     void redraw()
     {
         game_results = -1;  // Сбрасываем результат игры
-        history_mtx.clear();  // Очищаем историю ходов
-        history_beat_series.clear();  // Очищаем историю серий ударов
+        history.clear();  // Очищаем журнал ходов
+        redo_history.clear();  // Очищаем отмененные ходы
         make_start_mtx();  // Создаем начальную расстановку
+        has_search = false;  // Убираем панель поиска прошлой партии
         clear_active();  // Сбрасываем выделение активной клетки
         clear_highlight();  // Очищаем подсветку
     }
@@ -107,38 +122,34 @@ public:
     // Перемещает шашку на основе структуры move_pos
     // beat_series - номер удара в серии (для анимации)
     void move_piece(move_pos turn, const int beat_series = 0)
-    {
-        // Если ход включает бой, удаляем побитую шашку
-        if (turn.xb != -1)
-        {
-            mtx[turn.xb][turn.yb] = 0;
-        }
-        // Выполняем перемещение
-        move_piece(turn.x, turn.y, turn.x2, turn.y2, beat_series);
-    }
-
-    // Перемещает шашку с проверкой корректности хода
-    void move_piece(const POS_T i, const POS_T j, const POS_T i2, const POS_T j2, const int beat_series = 0)
     {
         // Проверка: конечная позиция должна быть пустой
-        if (mtx[i2][j2])
+        if (mtx[turn.x2][turn.y2])
         {
             throw runtime_error("final position is not empty, can't move");
         }
         // Проверка: начальная позиция должна содержать шашку
-        if (!mtx[i][j])
+        if (!mtx[turn.x][turn.y])
         {
             throw runtime_error("begin position is empty, can't move");
         }
 
-        // Превращение в дамку: если шашка достигает противоположного края доски
-        if ((mtx[i][j] == 1 && i2 == 0) || (mtx[i][j] == 2 && i2 == 7))
-            mtx[i][j] += 2;  // 1->3 (белая дамка), 2->4 (черная дамка)
+        // Запоминаем побитую шашку и факт превращения для журнала ходов
+        const POS_T captured = (turn.xb != -1 ? mtx[turn.xb][turn.yb] : 0);
+        const bool promoted = (mtx[turn.x][turn.y] == 1 && turn.x2 == 0) || (mtx[turn.x][turn.y] == 2 && turn.x2 == 7);
+        history_entry entry(turn, captured, promoted, beat_series);
 
-        // Перемещаем шашку
-        mtx[i2][j2] = mtx[i][j];
-        drop_piece(i, j);  // Удаляем шашку с исходной позиции
-        add_history(beat_series);  // Сохраняем состояние в историю
+        // Новый ход делает отмененные ходы недоступными для повтора
+        redo_history.clear();
+        apply_entry(mtx, entry);
+        add_history(entry);  // Сохраняем ход в журнал
+        rerender();
+    }
+
+    // Перемещает шашку с проверкой корректности хода
+    void move_piece(const POS_T i, const POS_T j, const POS_T i2, const POS_T j2, const int beat_series = 0)
+    {
+        move_piece(move_pos(i, j, i2, j2), beat_series);
     }
 
     // Удаляет шашку с доски и перерисовывает
@@ -159,12 +170,22 @@ public:
         rerender();
     }
 
-    // Возвращает текущее состояние доски
-    vector<vector<POS_T>> get_board() const
+    // Возвращает текущее состояние доски (без копирования)
+    const vector<vector<POS_T>>& get_board() const
     {
         return mtx;
     }
 
+    // Устанавливает произвольную позицию и начинает с нее новый журнал ходов
+    // Используется для анализа позиций без окна (бенчмарк), поэтому не перерисовывает доску
+    void set_board(const vector<vector<POS_T>>& new_mtx)
+    {
+        mtx = new_mtx;
+        history.clear();
+        redo_history.clear();
+        keyframes.assign(1, pack_keyframe(mtx));
+    }
+
     // Подсвечивает указанные клетки (для показа возможных ходов)
     void highlight_cells(vector<pair<POS_T, POS_T>> cells)
     {
@@ -202,6 +223,27 @@ public:
         rerender();
     }
 
+    // Задает подсказки - лучшие ходы с оценками (рисуются при следующей перерисовке)
+    void set_hints(vector<ranked_turn> turns)
+    {
+        hints = move(turns);
+    }
+
+    // Убирает подсказки (рисуются при следующей перерисовке)
+    void clear_hints()
+    {
+        hints.clear();
+    }
+
+    // Показывает панель поиска бота (HUD/Enabled) со снимком s и перерисовывает доску
+    // Пока поиск идет, на доске рисуется его главная линия; после поиска остаются итоговые показатели
+    void show_search(const search_snapshot& s)
+    {
+        search = s;
+        has_search = true;
+        rerender();
+    }
+
     // Проверяет, подсвечена ли указанная клетка
     bool is_highlighted(const POS_T x, const POS_T y)
     {
@@ -209,19 +251,104 @@ public:
     }
 
     // Отменяет последний ход (или серию ударов)
+    // Отмененные перемещения сохраняются и могут быть повторены через redo()
     void rollback()
     {
+        if (history.empty())
+            return;
         // Определяем, сколько ходов отменять (для серии ударов отменяем всю серию)
-        auto beat_series = max(1, *(history_beat_series.rbegin()));
-        while (beat_series-- && history_mtx.size() > 1)
+        int beat_series = max(1, int(history.back().beat_series));
+        while (beat_series-- && !history.empty())
         {
-            history_mtx.pop_back();
-            history_beat_series.pop_back();
+            undo_entry(mtx, history.back());
+            redo_history.push_back(history.back());
+            history.pop_back();
+        }
+        // Журнал повторов ограничен: самые дальние отмененные ходы забываются целиком, со всей серией ударов
+        // (в начале redo_history - последний удар самого дальнего хода)
+        while (redo_history.size() > MAX_REDO)
+        {
+            size_t count = 0;
+            while (count + 1 < redo_history.size() && redo_history[count].beat_series > 1)
+                ++count;
+            redo_history.erase(redo_history.begin(), redo_history.begin() + count + 1);
+        }
+        // Удаляем опорные кадры, которые оказались впереди текущего хода
+        while (keyframe_interval && keyframes.size() > 1 &&
+            (keyframes.size() - 1) * keyframe_interval > history.size())
+        {
+            keyframes.pop_back();
+        }
+        clear_highlight();
+        clear_active();
+    }
+
+    // Повторяет последний отмененный ход (вместе со всей серией ударов)
+    // Возвращает false, если повторять нечего
+    bool redo()
+    {
+        if (redo_history.empty())
+            return false;
+        int last_series = 0;
+        // Продолжение серии ударов имеет номер на единицу больше предыдущего
+        while (!redo_history.empty() &&
+            (last_series == 0 || redo_history.back().beat_series == last_series + 1))
+        {
+            history_entry entry = redo_history.back();
+            redo_history.pop_back();
+            apply_entry(mtx, entry);
+            add_history(entry);
+            last_series = entry.beat_series;
+            if (last_series == 0)
+                break;
         }
-        // Восстанавливаем состояние доски из истории
-        mtx = *(history_mtx.rbegin());
         clear_highlight();
         clear_active();
+        return true;
+    }
+
+    // Количество ходов в журнале (перемещений с начала партии)
+    size_t history_size() const
+    {
+        return history.size();
+    }
+
+    // Количество отмененных ходов, доступных для повтора
+    size_t redo_size() const
+    {
+        return redo_history.size();
+    }
+
+    // Восстанавливает состояние доски после ply первых перемещений журнала
+    // Начинает с ближайшего опорного кадра или с текущей позиции, если она ближе
+    vector<vector<POS_T>> get_board_at(const size_t ply) const
+    {
+        if (ply > history.size())
+            throw runtime_error("history has no such ply");
+        const size_t key = (keyframe_interval ? min(ply / keyframe_interval, keyframes.size() - 1) : 0);
+        const size_t key_ply = key * keyframe_interval;
+        vector<vector<POS_T>> res;
+        if (history.size() - ply < ply - key_ply)
+        {
+            // Откатываем текущую позицию назад
+            res = mtx;
+            for (size_t i = history.size(); i > ply; --i)
+                undo_entry(res, history[i - 1]);
+        }
+        else
+        {
+            // Проигрываем журнал вперед от опорного кадра
+            res = unpack_keyframe(keyframes[key]);
+            for (size_t i = key_ply; i < ply; ++i)
+                apply_entry(res, history[i]);
+        }
+        return res;
+    }
+
+    // Возвращает запись журнала с указанным номером
+    const history_entry& get_history(const size_t ply) const
+    {
+        return history[ply];
     }
 
     // Показывает финальный экран с результатом игры
@@ -262,11 +389,60 @@ public:
     }
 
 private:
-    // Сохраняет текущее состояние доски в историю
-    void add_history(const int beat_series = 0)
+    // Добавляет ход в журнал и, если пора, сохраняет опорный кадр
+    void add_history(const history_entry& entry)
     {
-        history_mtx.push_back(mtx);
-        history_beat_series.push_back(beat_series);
+        alloc_scope scope(alloc_subsystem::HISTORY);
+        history.push_back(entry);
+        if (keyframe_interval && history.size() % keyframe_interval == 0 &&
+            keyframes.size() == history.size() / keyframe_interval)
+        {
+            keyframes.push_back(pack_keyframe(mtx));
+        }
+    }
+
+    // Выполняет записанное перемещение на матрице доски
+    static void apply_entry(vector<vector<POS_T>>& m, const history_entry& entry)
+    {
+        if (entry.beaten != history_entry::NO_CELL)
+            m[entry.xb()][entry.yb()] = 0;
+        POS_T piece = m[entry.x()][entry.y()];
+        if (entry.promoted)
+            piece += 2;  // 1->3 (белая дамка), 2->4 (черная дамка)
+        m[entry.x()][entry.y()] = 0;
+        m[entry.x2()][entry.y2()] = piece;
+    }
+
+    // Отменяет записанное перемещение на матрице доски
+    static void undo_entry(vector<vector<POS_T>>& m, const history_entry& entry)
+    {
+        POS_T piece = m[entry.x2()][entry.y2()];
+        if (entry.promoted)
+            piece -= 2;
+        m[entry.x2()][entry.y2()] = 0;
+        m[entry.x()][entry.y()] = piece;
+        if (entry.beaten != history_entry::NO_CELL)
+            m[entry.xb()][entry.yb()] = entry.captured;
+    }
+
+    // Упаковывает игровые клетки доски в опорный кадр
+    static history_keyframe pack_keyframe(const vector<vector<POS_T>>& m)
+    {
+        history_keyframe key{};
+        for (POS_T i = 0; i < 8; ++i)
+            for (POS_T j = (i + 1) % 2; j < 8; j += 2)
+                key[i * 4 + j / 2] = m[i][j];
+        return key;
+    }
+
+    // Распаковывает опорный кадр в матрицу доски
+    static vector<vector<POS_T>> unpack_keyframe(const history_keyframe& key)
+    {
+        vector<vector<POS_T>> m(8, vector<POS_T>(8, 0));
+        for (POS_T i = 0; i < 8; ++i)
+            for (POS_T j = (i + 1) % 2; j < 8; j += 2)
+                m[i][j] = key[i * 4 + j / 2];
+        return m;
     }
 
     // Создает начальную расстановку шашек на доске
@@ -285,12 +461,14 @@ private:
                     mtx[i][j] = 1;
             }
         }
-        add_history();  // Сохраняем начальное состояние в историю
+        keyframes.assign(1, pack_keyframe(mtx));  // Начальная позиция - нулевой опорный кадр журнала
     }
 
     // Полная перерисовка всех элементов на экране
     void rerender()
     {
+        trace_span span("rerender", "render");
+        alloc_scope scope(alloc_subsystem::RENDERING);
         // Очищаем рендерер
         SDL_RenderClear(ren);
         // Отрисовываем фон доски
@@ -305,9 +483,7 @@ private:
                     continue;
 
                 // Вычисляем позицию для отрисовки шашки
-                int wpos = W * (j + 1) / 10 + W / 120;
-                int hpos = H * (i + 1) / 10 + H / 120;
-                SDL_Rect rect{ wpos, hpos, W / 12, H / 12 };
+                SDL_Rect rect = piece_rect(W, H, i, j);
 
                 // Выбираем текстуру в зависимости от типа шашки
                 SDL_Texture* piece_texture;
@@ -348,7 +524,10 @@ private:
                                  int(W / 10 / scale), int(H / 10 / scale) };
             SDL_RenderDrawRect(ren, &active_cell);
         }
+        draw_hints(scale);
+        draw_search_pv(scale);
         SDL_RenderSetScale(ren, 1, 1);
+        draw_search_panel();
 
         // Отрисовываем кнопки управления
         SDL_Rect rect_left{ W / 40, H / 40, W / 15, H / 15 };
@@ -377,7 +556,11 @@ private:
         }
 
         // Обновляем экран
-        SDL_RenderPresent(ren);
+        {
+            trace_span present_span("SDL_RenderPresent", "render");
+            SDL_RenderPresent(ren);
+        }
+        Input_log::get().presented();
 
         // Небольшая задержка и обработка событий (особенно для Mac OS)
         SDL_Delay(10);
@@ -385,19 +568,182 @@ private:
         SDL_PollEvent(&windowEvent);
     }
 
+    // Рисует подсказки: путь каждого хода от начальной клетки через все удары (лучший - синим, остальные -
+    // желтым) и под конечной клеткой полосу оценки относительно лучшего хода
+    void draw_hints(const double scale)
+    {
+        if (hints.empty())
+            return;
+        const int best = hints.front().score;
+        auto center_x = [&](const int col) { return int(W * (col + 1.5) / 10 / scale); };
+        auto center_y = [&](const int row) { return int(H * (row + 1.5) / 10 / scale); };
+        for (size_t rank = hints.size(); rank-- > 0;)
+        {
+            const ranked_turn& hint = hints[rank];
+            if (hint.turns.empty())
+                continue;
+            if (rank == 0)
+                SDL_SetRenderDrawColor(ren, 0, 128, 255, 0);
+            else
+                SDL_SetRenderDrawColor(ren, 255, 200, 0, 0);
+            for (const move_pos& turn : hint.turns)
+                SDL_RenderDrawLine(ren, center_x(turn.y), center_y(turn.x), center_x(turn.y2), center_y(turn.x2));
+
+            const move_pos& last = hint.turns.back();
+            // Полоса короче на четверть за каждые полшашки отставания от лучшего хода
+            const double share = min(1.0, max(0.0, 1 - (best - hint.score) / 200.0));
+            SDL_Rect bar{ int(W * (last.y2 + 1) / 10 / scale), int(H * (last.x2 + 2) / 10 / scale) - 2,
+                          max(1, int(W / 10 / scale * share)), 2 };
+            SDL_RenderFillRect(ren, &bar);
+        }
+    }
+
+    // Рисует главную линию идущего поиска стрелками: ходы бота - голубым, ответы соперника - оранжевым,
+    // дальние ходы линии бледнее
+    void draw_search_pv(const double scale)
+    {
+        if (!has_search || !search.running || !search.has_score)
+            return;
+        SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_BLEND);
+        for (int i = search.segments; i-- > 0;)
+        {
+            const search_snapshot::segment& seg = search.pv[i];
+            const Uint8 alpha = Uint8(max(80, 255 - 40 * seg.ply));
+            if (seg.ply % 2 == 0)
+                SDL_SetRenderDrawColor(ren, 0, 200, 255, alpha);
+            else
+                SDL_SetRenderDrawColor(ren, 255, 140, 0, alpha);
+            const double x1 = W * (dark_cell_y(seg.from) + 1.5) / 10 / scale, y1 = H * (dark_cell_x(seg.from) + 1.5) / 10 / scale;
+            const double x2 = W * (dark_cell_y(seg.to) + 1.5) / 10 / scale, y2 = H * (dark_cell_x(seg.to) + 1.5) / 10 / scale;
+            SDL_RenderDrawLine(ren, int(x1), int(y1), int(x2), int(y2));
+            // Наконечник стрелки: два отрезка под 30 градусов к ходу
+            const double len = hypot(x2 - x1, y2 - y1), head = W / 60 / scale;
+            if (len < 1)
+                continue;
+            const double ux = (x1 - x2) / len, uy = (y1 - y2) / len;
+            for (const double sign : { -1.0, 1.0 })
+            {
+                const double hx = ux * 0.866 - sign * uy * 0.5, hy = uy * 0.866 + sign * ux * 0.5;
+                SDL_RenderDrawLine(ren, int(x2), int(y2), int(x2 + hx * head), int(y2 + hy * head));
+            }
+        }
+        SDL_SetRenderDrawBlendMode(ren, SDL_BLENDMODE_NONE);
+    }
+
+    // Рисует показатели поиска под доской и шкалу оценки слева от доски (доля белых снизу)
+    void draw_search_panel()
+    {
+        if (!has_search)
+            return;
+        // Шкала: оценка бота score (сотые доли шашки) переводится в долю 1/2 + score / 2000, 1/2 - равенство,
+        // перевес в 10 шашек или найденный выигрыш - вся шкала
+        const double bot_share = min(1.0, max(0.0, 0.5 + search.score / 2000.0));
+        const double white_share = search.has_score ? (search.color ? 1 - bot_share : bot_share) : 0.5;
+        const SDL_Rect bar{ W / 30, H / 10, W / 30, H * 8 / 10 };
+        const int white_h = int(bar.h * white_share);
+        SDL_SetRenderDrawColor(ren, 40, 40, 40, 0);
+        SDL_RenderFillRect(ren, &bar);
+        SDL_Rect white_part{ bar.x, bar.y + bar.h - white_h, bar.w, white_h };
+        SDL_SetRenderDrawColor(ren, 240, 240, 240, 0);
+        SDL_RenderFillRect(ren, &white_part);
+        SDL_SetRenderDrawColor(ren, 255, 0, 0, 0);
+        SDL_RenderDrawLine(ren, bar.x, bar.y + bar.h / 2, bar.x + bar.w - 1, bar.y + bar.h / 2);
+
+        char line1[96], line2[96];
+        char score[24] = "-";  // "LOSS " и любое int
+        if (search.has_score)
+        {
+            if (is_win_score(search.score))
+                snprintf(score, sizeof(score), "WIN %d", score_distance(search.score));
+            else if (is_loss_score(search.score))
+                snprintf(score, sizeof(score), "LOSS %d", score_distance(search.score));
+            else
+                snprintf(score, sizeof(score), "%+.2f", search.score / 100.0);
+        }
+        snprintf(line1, sizeof(line1), "DEPTH %d MOVE %d/%d SCORE %s", search.depth, search.root_move,
+            search.root_moves, score);
+        const double seconds = search.elapsed_ms / 1000;
+        snprintf(line2, sizeof(line2), "NODES %llu NPS %llu TIME %.1fS", (unsigned long long)search.nodes,
+            (unsigned long long)(seconds > 0 ? search.nodes / seconds : 0), seconds);
+        const int pixel = max(1, H / 200);
+        SDL_SetRenderDrawColor(ren, search.running ? 255 : 160, search.running ? 255 : 160, search.running ? 0 : 160, 0);
+        draw_text(line1, W / 10, H * 9 / 10 + pixel * 2, pixel);
+        draw_text(line2, W / 10, H * 9 / 10 + pixel * 9, pixel);
+    }
+
+    // Рисует строку встроенным шрифтом 3x5 (цифры, заглавные буквы панели и знаки ". / - +"),
+    // pixel - размер точки шрифта; неизвестные символы пропускаются
+    void draw_text(const char* text, int x, const int y, const int pixel)
+    {
+        for (; *text; ++text, x += pixel * 4)
+        {
+            const uint16_t glyph = font_glyph(*text);
+            for (int row = 0; row < 5; ++row)
+            {
+                for (int col = 0; col < 3; ++col)
+                {
+                    if (!((glyph >> (14 - row * 3 - col)) & 1))
+                        continue;
+                    SDL_Rect dot{ x + col * pixel, y + row * pixel, pixel, pixel };
+                    SDL_RenderFillRect(ren, &dot);
+                }
+            }
+        }
+    }
+
+    // Точки символа: 5 строк по 3 бита, старшие биты - верхняя строка
+    static uint16_t font_glyph(const char c)
+    {
+        static const uint16_t digits[10] = { 0b111101101101111, 0b010110010010111, 0b111001111100111, 0b111001111001111,
+            0b101101111001001, 0b111100111001111, 0b111100111101111, 0b111001001001001, 0b111101111101111,
+            0b111101111001111 };
+        if (c >= '0' && c <= '9')
+            return digits[c - '0'];
+        switch (c)
+        {
+        case 'C': return 0b111100100100111;
+        case 'D': return 0b110101101101110;
+        case 'E': return 0b111100111100111;
+        case 'H': return 0b101101111101101;
+        case 'I': return 0b111010010010111;
+        case 'L': return 0b100100100100111;
+        case 'M': return 0b101111111101101;
+        case 'N': return 0b110101101101101;
+        case 'O': return 0b010101101101010;
+        case 'P': return 0b111101111100100;
+        case 'R': return 0b110101110101101;
+        case 'S': return 0b011100010001110;
+        case 'T': return 0b111010010010010;
+        case 'V': return 0b101101101101010;
+        case 'W': return 0b101101111111101;
+        case '.': return 0b000000000000010;
+        case '/': return 0b001001010100100;
+        case '-': return 0b000000111000000;
+        case '+': return 0b000010111010000;
+        default: return 0;
+        }
+    }
+
+public:
+    // Прямоугольник шашки на клетке (i, j) для доски размером W x H
+    // Общая разметка для окна и для отрисовки без окна (Offscreen_renderer)
+    static SDL_Rect piece_rect(const int W, const int H, const POS_T i, const POS_T j)
+    {
+        return SDL_Rect{ W * (j + 1) / 10 + W / 120, H * (i + 1) / 10 + H / 120, W / 12, H / 12 };
+    }
+
+private:
     // Записывает сообщение об ошибке в лог-файл
     void print_exception(const string& text) {
-        ofstream fout(project_path + "log.txt", ios_base::app);
-        fout << "Error: " << text << ". " << SDL_GetError() << endl;
-        fout.close();
+        Logger::get().error(text.c_str(), { { "sdl_error", SDL_GetError() } });
     }
 
 public:
     int W = 0;  // Ширина окна
     int H = 0;  // Высота окна
 
-    // История состояний доски (для реализации отмены хода)
-    vector<vector<vector<POS_T>>> history_mtx;
+    // Через сколько ходов журнала сохранять опорный кадр (0 - только начальная позиция)
+    unsigned int keyframe_interval = 0;
 
 private:
     SDL_Window* win = nullptr;     // Указатель на окно SDL
@@ -412,6 +758,9 @@ private:
     SDL_Texture* back = nullptr;     // Текстура кнопки "Назад"
     SDL_Texture* replay = nullptr;   // Текстура кнопки "Повтор"
 
+    // Отрисовка без окна использует те же файлы текстур
+    friend class Offscreen_renderer;
+
     // Пути к файлам с текстурами
     const string textures_path = project_path + "Textures/";
     const string board_path = textures_path + "board.png";
@@ -434,12 +783,24 @@ private:
     // Матрица подсвеченных клеток (для показа возможных ходов)
     vector<vector<bool>> is_highlighted_ = vector<vector<bool>>(8, vector<bool>(8, 0));
 
+    // Подсказки: лучшие ходы игрока по убыванию оценки (Bot/Hints)
+    vector<ranked_turn> hints;
+
+    // Панель поиска бота (HUD/Enabled): последний показанный снимок поиска
+    search_snapshot search;
+    bool has_search = false;
+
     // Матрица состояния доски:
     // 0 - пустая клетка
     // 1 - белая шашка, 2 - черная шашка
     // 3 - белая дамка, 4 - черная дамка
     vector<vector<POS_T>> mtx = vector<vector<POS_T>>(8, vector<POS_T>(8, 0));
 
-    // История серий ударов (для корректной отмены хода при множественных боях)
-    vector<int> history_beat_series;
+    // Журнал ходов (для отмены хода и восстановления любой позиции партии)
+    vector<history_entry> history;
+    // Отмененные ходы в обратном порядке (последний элемент повторяется первым), не больше MAX_REDO
+    vector<history_entry> redo_history;
+    static const size_t MAX_REDO = 256;
+    // Опорные кадры: позиция после каждых keyframe_interval ходов, нулевой - начальная позиция
+    vector<history_keyframe> keyframes;
 };
\ No newline at end of file
@@ -19,7 +19,7 @@ public:
     void reload()
     {
         std::ifstream fin(project_path + "settings.json");
-        fin >> config;  // Парсинг JSON из файла в объект json
+        config = json::parse(fin, nullptr, true, true);  // Парсинг JSON из файла в объект json (с комментариями)
         fin.close();
     }
 
@@ -31,6 +31,20 @@ public:
         return config[setting_dir][setting_name];
     }
 
+    // Переопределяет значение настройки до следующего reload()
+    // Пример: config.set("Bot", "NoRandom", true) в режиме бенчмарка
+    void set(const string& setting_dir, const string& setting_name, const json& value)
+    {
+        config[setting_dir][setting_name] = value;
+    }
+
+    // Возвращает раздел настроек целиком (пустой объект, если раздела нет)
+    // Пример: config.section("O2") для записи параметров поиска в файл воспроизведения
+    json section(const string& setting_dir) const
+    {
+        return config.value(setting_dir, json::object());
+    }
+
 private:
     json config;  // Внутренний объект для хранения конфигурационных данных в формате JSON
 };
\ No newline at end of file
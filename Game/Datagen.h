@@ -0,0 +1,287 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Models/Train_record.h"
+#include "Bench.h"
+#include "Board.h"
+#include "Config.h"
+#include "Draw_rule.h"
+#include "Logic.h"
+
+// Класс Shard_writer - запись обучающих позиций одного потока в файлы shard_<поток>_<номер>.bin
+// У каждого потока свои файлы, поэтому запись не требует блокировок. Файл закрывается после
+// records_per_shard записей и открывается следующий
+class Shard_writer
+{
+public:
+    Shard_writer(const string& dir, const unsigned thread_id, const size_t records_per_shard)
+        : dir(dir), thread_id(thread_id), records_per_shard(max<size_t>(records_per_shard, 1))
+    {
+    }
+
+    // Дописывает записи партии; false - файл не открылся или запись не удалась
+    bool write(const vector<train_record>& records)
+    {
+        for (const train_record& rec : records)
+        {
+            if (!fout.is_open() || in_shard == records_per_shard)
+            {
+                if (!open_next())
+                    return false;
+            }
+            fout.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+            ++in_shard;
+        }
+        return bool(fout);
+    }
+
+private:
+    bool open_next()
+    {
+        if (fout.is_open())
+            fout.close();
+        ostringstream name;
+        name << "shard_" << setw(3) << setfill('0') << thread_id << "_" << setw(5) << shard++ << ".bin";
+        fout.open((filesystem::path(dir) / name.str()).string(), ios_base::binary | ios_base::trunc);
+        if (!fout)
+            return false;
+        const uint32_t record_size = sizeof(train_record), reserved = 0;
+        fout.write(TRAIN_SHARD_MAGIC, sizeof(TRAIN_SHARD_MAGIC));
+        fout.write(reinterpret_cast<const char*>(&record_size), sizeof(record_size));
+        fout.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+        in_shard = 0;
+        return bool(fout);
+    }
+
+    string dir;
+    unsigned thread_id;
+    size_t records_per_shard;
+    ofstream fout;
+    int shard = 0;         // Номер следующего файла
+    size_t in_shard = 0;   // Записей в текущем файле
+};
+
+// Класс Datagen - режим "datagen": генерация обучающих позиций партиями бота против себя без окна
+// Партия начинается с RandomPlies случайных ходов (начало зависит только от Seed и номера партии), дальше
+// оба цвета играет поиск уровня Level. Записываются тихие позиции (взятий нет ни у ходящего, ни у соперника)
+// с оценкой поиска и итогом партии; повторы отбрасываются по хешу позиции через общую таблицу без
+// блокировок. Партии играются на Threads потоках, каждый пишет свои файлы (Shard_writer)
+class Datagen
+{
+public:
+    explicit Datagen(const int games) : games(games)
+    {
+        Config config;
+        dir = project_path + string(config("DataGen", "Dir"));
+        level = config("DataGen", "Level");
+        random_plies = config("DataGen", "RandomPlies");
+        shard_records = size_t(int(config("DataGen", "ShardRecords")));
+        seed = config("DataGen", "Seed");
+        threads = config("DataGen", "Threads");
+        if (threads == 0)
+            threads = max(1u, thread::hardware_concurrency());
+        // Таблица хешей - степень двойки ячеек по 8 байт
+        const size_t bytes = size_t(int(config("DataGen", "DedupMB"))) << 20;
+        size_t cells = 1024;
+        while (cells * 2 * sizeof(uint64_t) <= bytes)
+            cells *= 2;
+        seen = make_unique<atomic<uint64_t>[]>(cells);
+        seen_mask = cells - 1;
+    }
+
+    int run()
+    {
+        error_code ec;
+        filesystem::create_directories(dir, ec);
+        if (ec)
+        {
+            cerr << "Can't create " << dir << endl;
+            return 1;
+        }
+        cout << games << " games, level " << level << ", " << random_plies << " random plies, " << threads
+             << " threads -> " << dir << endl;
+
+        auto start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for (unsigned i = 0; i < threads; ++i)
+            workers.emplace_back(&Datagen::worker, this, i);
+        // Ход работы раз в несколько секунд
+        while (games_done.load(memory_order_relaxed) < games && !failed.load(memory_order_relaxed))
+        {
+            this_thread::sleep_for(chrono::milliseconds(200));
+            const double s = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            if (s >= next_report)
+            {
+                next_report += 5;
+                print_progress(s);
+            }
+        }
+        for (auto& worker : workers)
+            worker.join();
+        const double s = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "===========================\n";
+        print_progress(s);
+        if (failed)
+        {
+            cerr << "Can't write shards to " << dir << endl;
+            return 1;
+        }
+        return 0;
+    }
+
+private:
+    typedef Logic::rules rules;
+
+    // Играет партии, пока не сыграны все
+    void worker(const unsigned thread_id)
+    {
+        Config config;
+        config.set("Bot", "NoRandom", true);
+        config.set("Bot", "Engine", "Minimax");
+        config.set("Cache", "File", "");
+        config.set("TreeDump", "File", "");
+        config.set("FlightRecorder", "Searches", 0);
+        Board board;
+        Logic logic(&board, &config);
+        logic.Max_depth = level;
+        const int max_turns = config("Game", "MaxNumTurns");
+        Draw_rule draw_rule(config);
+        Shard_writer writer(dir, thread_id, shard_records);
+        vector<train_record> records;
+        while (!failed.load(memory_order_relaxed))
+        {
+            const int game = next_game.fetch_add(1, memory_order_relaxed);
+            if (game >= games)
+                break;
+            const size_t repeated = play_game(logic, draw_rule, max_turns, game, records);
+            if (!writer.write(records))
+                failed.store(true, memory_order_relaxed);
+            // Общие счетчики обновляются раз в партию
+            positions.fetch_add(records.size(), memory_order_relaxed);
+            duplicates.fetch_add(repeated, memory_order_relaxed);
+            games_done.fetch_add(1, memory_order_relaxed);
+        }
+    }
+
+    // Одна партия: позиции попадают в records с итогом партии; возвращает число отброшенных повторов
+    size_t play_game(Logic& logic, Draw_rule& draw_rule, const int max_turns, const int game, vector<train_record>& records)
+    {
+        size_t repeated = 0;
+        mt19937 rand_eng(uint32_t(seed) * 1000003u + uint32_t(game));
+        board_t mtx = Logic::to_board(Bench::parse_position("bbbbbbbbbbbb........wwwwwwwwwwww"));
+        draw_rule.clear();
+        records.clear();
+        int winner = -1;  // 0 - белые, 1 - черные, -1 - ничья
+        Logic::chain_list chains, replies;
+        for (int turn_num = 0; turn_num < max_turns; ++turn_num)
+        {
+            const bool color = turn_num % 2;
+            rules::generate(mtx, color, chains);
+            if (chains.empty())
+            {
+                winner = !color;
+                break;
+            }
+            if (draw_rule.add(mtx, color) != draw_reason::NONE)
+                break;
+            if (turn_num < random_plies)
+            {
+                mtx = rules::make_move(mtx, chains.items[rand_eng() % chains.size]);
+                continue;
+            }
+
+            logic.set_game_history(draw_rule.search_history());
+            const vector<ranked_turn> best = logic.find_ranked_turns(mtx, color, 1);
+            if (best.empty())
+                break;
+            // Тихая позиция: взятий нет ни у ходящего, ни у соперника
+            bool quiet = chains.items[0].count == 0;
+            if (quiet)
+            {
+                rules::generate(mtx, !color, replies);
+                quiet = replies.empty() || replies.items[0].count == 0;
+            }
+            if (quiet)
+            {
+                if (insert_hash(Logic::position_hash(mtx, color)))
+                    records.push_back(make_record(mtx, color, turn_num, best.front().score));
+                else
+                    ++repeated;
+            }
+            for (const move_pos& turn : best.front().turns)
+                mtx = Logic::make_turn(mtx, packed_move(turn));
+        }
+        for (train_record& rec : records)
+            rec.result = int8_t(winner < 0 ? 0 : winner == rec.color ? 1 : -1);
+        return repeated;
+    }
+
+    static train_record make_record(const board_t& mtx, const bool color, const int ply, const int score)
+    {
+        train_record rec;
+        for (uint32_t cell = 0; cell < 32; ++cell)
+        {
+            const uint32_t bit = 1u << cell;
+            rec.white_men |= mtx[cell] == 1 ? bit : 0;
+            rec.black_men |= mtx[cell] == 2 ? bit : 0;
+            rec.white_kings |= mtx[cell] == 3 ? bit : 0;
+            rec.black_kings |= mtx[cell] == 4 ? bit : 0;
+        }
+        rec.score = int16_t(score);
+        rec.ply = uint16_t(ply);
+        rec.color = uint8_t(color);
+        return rec;
+    }
+
+    // Добавляет хеш в общую таблицу (открытая адресация, CAS без блокировок)
+    // false - позиция уже встречалась; при переполненной окрестности позиция считается новой
+    bool insert_hash(uint64_t hash)
+    {
+        hash |= 1;  // 0 - пустая ячейка
+        for (size_t i = hash & seen_mask, probe = 0; probe < 32; ++probe, i = (i + 1) & seen_mask)
+        {
+            uint64_t cur = seen[i].load(memory_order_relaxed);
+            if (cur == 0 && seen[i].compare_exchange_strong(cur, hash, memory_order_relaxed))
+                return true;
+            if (cur == hash)
+                return false;
+        }
+        return true;
+    }
+
+    void print_progress(const double seconds) const
+    {
+        const uint64_t n = positions.load(memory_order_relaxed);
+        cout << "Games " << games_done.load(memory_order_relaxed) << "/" << games << ", positions " << n
+             << ", duplicates " << duplicates.load(memory_order_relaxed) << ", " << (long long)(n / max(seconds, 1e-3))
+             << " positions/s" << endl;
+    }
+
+    int games;
+    string dir;
+    int level = 4;
+    int random_plies = 8;
+    size_t shard_records = 1000000;
+    int seed = 1;
+    unsigned threads = 1;
+    unique_ptr<atomic<uint64_t>[]> seen;  // Хеши записанных позиций
+    size_t seen_mask = 0;
+    double next_report = 5;
+
+    atomic<int> next_game{ 0 };
+    atomic<int> games_done{ 0 };
+    atomic<uint64_t> positions{ 0 };
+    atomic<uint64_t> duplicates{ 0 };
+    atomic<bool> failed{ false };
+};
@@ -0,0 +1,104 @@
+#pragma once
+#include <vector>
+
+#include "../Models/Move.h"
+#include "Config.h"
+#include "Logic.h"
+
+using namespace std;
+
+// Причина ничьей по правилу Draw_rule
+enum class draw_reason
+{
+    NONE,
+    REPETITION,  // Позиция повторилась RepetitionDraw раз
+    NO_PROGRESS  // NoProgressDraw ходов подряд без взятий и ходов простыми шашками
+};
+
+// Класс Draw_rule - ничья по повторению позиции и по отсутствию прогресса (раздел "Game")
+// Хранит позиции партии; повториться может только позиция внутри серии обратимых ходов (тихих ходов дамок),
+// поэтому сравниваются лишь позиции этой серии с тем же цветом хода. Хеши серии - история для поиска
+// (Logic::set_game_history): поиск считает ничьей уже первое повторение
+class Draw_rule
+{
+public:
+    // repetitions - сколько раз должна встретиться позиция (0 - правило выключено)
+    // no_progress - ходов без взятий и ходов простыми шашками до ничьей (0 - правило выключено)
+    Draw_rule(const int repetitions, const int no_progress) : repetitions(repetitions), no_progress(no_progress)
+    {
+    }
+
+    explicit Draw_rule(const Config& config) : Draw_rule(config("Game", "RepetitionDraw"), config("Game", "NoProgressDraw"))
+    {
+    }
+
+    // Забывает позиции после первых count (отмена ходов); clear() - новая партия
+    void truncate(const size_t count)
+    {
+        if (positions.size() > count)
+        {
+            positions.resize(count);
+            hashes.resize(count);
+        }
+    }
+
+    void clear()
+    {
+        truncate(0);
+    }
+
+    // Добавляет позицию перед очередным ходом игрока color и проверяет правила ничьей
+    draw_reason add(const board_t& mtx, const bool color)
+    {
+        positions.push_back(mtx);
+        hashes.push_back(Logic::position_hash(mtx, color));
+        run = 0;
+        for (size_t i = positions.size() - 1; i > 0 && is_reversible(positions[i - 1], positions[i]); --i)
+            ++run;
+
+        int count = 1;
+        const size_t last = hashes.size() - 1;
+        for (size_t back = 4; back <= run; back += 2)
+            count += hashes[last - back] == hashes[last];
+        if (repetitions > 0 && count >= repetitions)
+            return draw_reason::REPETITION;
+        if (no_progress > 0 && run >= size_t(no_progress))
+            return draw_reason::NO_PROGRESS;
+        return draw_reason::NONE;
+    }
+
+    // Хеши позиций серии обратимых ходов перед последней добавленной позицией (от старых к новым)
+    vector<uint64_t> search_history() const
+    {
+        return vector<uint64_t>(hashes.end() - 1 - run, hashes.end() - 1);
+    }
+
+    static const char* name(const draw_reason reason)
+    {
+        return reason == draw_reason::REPETITION ? "repetition" : reason == draw_reason::NO_PROGRESS ? "no progress" : "";
+    }
+
+private:
+    // Обратим ли ход: ни одна фигура не побита и простые шашки не сдвигались (двигалась только дамка)
+    static bool is_reversible(const board_t& before, const board_t& after)
+    {
+        int pieces_before = 0, pieces_after = 0;
+        for (size_t cell = 0; cell < 32; ++cell)
+        {
+            pieces_before += before[cell] != 0;
+            pieces_after += after[cell] != 0;
+            if (before[cell] != after[cell] && (before[cell] == 1 || before[cell] == 2 || after[cell] == 1 ||
+                                                   after[cell] == 2))
+            {
+                return false;
+            }
+        }
+        return pieces_before == pieces_after;
+    }
+
+    int repetitions;
+    int no_progress;
+    vector<board_t> positions;  // Позиции партии перед каждым ходом
+    vector<uint64_t> hashes;    // Их хеши (с цветом хода)
+    size_t run = 0;             // Обратимых ходов подряд перед последней позицией
+};
@@ -0,0 +1,140 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Board.h"
+#include "Config.h"
+#include "Logic.h"
+
+// Структура engine_job - запрос хода бота для пула потоков поиска
+struct engine_job
+{
+    uint64_t session_id;                         // Кому вернуть результат
+    board_t mtx;                                 // Позиция
+    bool color;                                  // Цвет бота
+    int level;                                   // Уровень бота (глубина поиска)
+    chrono::steady_clock::time_point deadline;   // Крайний срок ответа
+    shared_ptr<atomic<bool>> cancel;             // Флаг отмены (партия закрыта)
+    vector<uint64_t> history;                    // История партии для ничьих повторением (Draw_rule::search_history)
+};
+
+// Структура engine_result - ответ пула на запрос хода
+struct engine_result
+{
+    uint64_t session_id;
+    vector<move_pos> turns;  // Серия ходов бота (пусто, если запрос отменен или просрочен)
+    bool timeout = false;    // Запрос не успел начаться до крайнего срока
+};
+
+// Класс Engine_pool - ограниченный пул потоков поиска, общий для всех партий
+// Запросы обслуживаются строго по очереди поступления; так как у каждой партии
+// одновременно не больше одного запроса, ни одна партия не ждет дольше остальных
+class Engine_pool
+{
+public:
+    // workers: количество потоков (0 - по числу ядер), capacity: максимальная длина очереди
+    // on_result: вызывается из потока поиска для каждого готового результата
+    Engine_pool(const Config& config, size_t workers, const size_t capacity,
+        function<void(engine_result&&)> on_result)
+        : capacity(capacity), on_result(move(on_result))
+    {
+        if (workers == 0)
+            workers = max(1u, thread::hardware_concurrency());
+        for (size_t i = 0; i < workers; ++i)
+            threads.emplace_back(&Engine_pool::work, this, config);
+    }
+
+    // Ставит запрос в очередь; возвращает false, если очередь заполнена
+    bool submit(engine_job&& job)
+    {
+        {
+            lock_guard<mutex> lock(jobs_mutex);
+            if (jobs.size() >= capacity)
+                return false;
+            jobs.push_back(move(job));
+        }
+        jobs_cv.notify_one();
+        return true;
+    }
+
+    // Количество запросов, ожидающих потока поиска
+    size_t queued()
+    {
+        lock_guard<mutex> lock(jobs_mutex);
+        return jobs.size();
+    }
+
+    // Останавливает потоки; невыполненные запросы отбрасываются
+    void stop()
+    {
+        {
+            lock_guard<mutex> lock(jobs_mutex);
+            if (is_stopped)
+                return;
+            is_stopped = true;
+            jobs.clear();
+        }
+        jobs_cv.notify_all();
+        for (auto& th : threads)
+            th.join();
+    }
+
+    ~Engine_pool()
+    {
+        stop();
+    }
+
+private:
+    // Поток поиска: у каждого потока свой экземпляр Logic, память между запросами не выделяется заново
+    void work(Config config)
+    {
+        Board board;
+        Logic logic(&board, &config);
+        while (true)
+        {
+            engine_job job;
+            {
+                unique_lock<mutex> lock(jobs_mutex);
+                jobs_cv.wait(lock, [this] { return is_stopped || !jobs.empty(); });
+                if (is_stopped)
+                    return;
+                job = move(jobs.front());
+                jobs.pop_front();
+            }
+
+            engine_result result;
+            result.session_id = job.session_id;
+            if (job.cancel->load())
+                continue;
+            if (chrono::steady_clock::now() >= job.deadline)
+            {
+                result.timeout = true;
+            }
+            else
+            {
+                logic.Max_depth = job.level;
+                logic.set_limits(job.cancel.get(), job.deadline);
+                logic.set_game_history(move(job.history));
+                result.turns = logic.find_best_turns(job.mtx, job.color);
+                if (job.cancel->load())
+                    continue;
+            }
+            on_result(move(result));
+        }
+    }
+
+    const size_t capacity;
+    function<void(engine_result&&)> on_result;
+    mutex jobs_mutex;
+    condition_variable jobs_cv;
+    deque<engine_job> jobs;
+    bool is_stopped = false;
+    vector<thread> threads;
+};
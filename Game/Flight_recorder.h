@@ -0,0 +1,162 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+using json = nlohmann::json;
+
+#include "../Models/Move.h"
+
+using namespace std;
+
+// Структура flight_entry - один поиск в журнале Flight_recorder
+struct flight_entry
+{
+    board_t mtx;                   // Позиция
+    bool color = false;            // Кто ходит
+    int depth = 0;                 // Max_depth
+    default_random_engine random;  // Генератор перемешивания ходов перед поиском - от него зависит порядок ходов
+    uint64_t nodes = 0;            // Узлов (для MCTS - симуляций)
+    double ms = 0;                 // Время поиска
+    bool stopped = false;          // Прерван отменой или крайним сроком
+};
+
+// Класс Flight_recorder - журнал последних поисков одного экземпляра Logic (раздел "FlightRecorder")
+// Хранит последние N поисков в кольцевом буфере. Поиск дольше порога ThresholdMS и (если MedianFactor > 0)
+// дольше медианы буфера в MedianFactor раз считается медленным: в папку Dir пишется самодостаточный файл
+// воспроизведения - позиция, история партии, генератор случайных чисел, настройки поиска и недавние поиски.
+// Файл повторяется точно командой "Checkers bench <файл>". Без срабатывания поиск стоит копии позиции,
+// генератора и истории партии (буфер истории переиспользуется)
+class Flight_recorder
+{
+public:
+    // settings - разделы настроек, от которых зависит поиск (пишутся в файл как есть)
+    Flight_recorder(const size_t capacity, const double threshold_ms, const double median_factor, const string& dir,
+        json settings)
+        : ring(max<size_t>(capacity, 1)), threshold_ms(threshold_ms), median_factor(median_factor), dir(dir),
+          settings(move(settings))
+    {
+    }
+
+    // Начало поиска: запоминает входные данные
+    // history - хеши позиций партии перед корнем (Logic::set_game_history): от них зависят ничьи повторением
+    void begin(const board_t& mtx, const bool color, const int depth, const default_random_engine& random,
+        const vector<uint64_t>& history)
+    {
+        current.mtx = mtx;
+        current_history.assign(history.begin(), history.end());
+        current.color = color;
+        current.depth = depth;
+        current.random = random;
+        start = chrono::steady_clock::now();
+    }
+
+    // Конец поиска: добавляет его в журнал; для медленного поиска пишет файл воспроизведения
+    // Возвращает путь к файлу (пустая строка - поиск не медленный или файл не записан)
+    string end(const uint64_t nodes, const bool stopped)
+    {
+        current.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        current.nodes = nodes;
+        current.stopped = stopped;
+        const bool slow = is_slow(current.ms);
+        ring[next % ring.size()] = current;
+        ++next;
+        if (!slow || files.fetch_add(1, memory_order_relaxed) >= MAX_FILES)
+            return "";
+        return write_repro();
+    }
+
+    // Строка позиции в формате бенчмарка: 32 символа по игровым клеткам, ".wbWB"
+    static string position_text(const board_t& mtx)
+    {
+        static const char symbols[] = ".wbWB";
+        string res(32, '.');
+        for (size_t cell = 0; cell < 32; ++cell)
+            res[cell] = symbols[mtx[cell]];
+        return res;
+    }
+
+    // Состояние генератора случайных чисел в виде строки (и обратно)
+    static string random_text(const default_random_engine& random)
+    {
+        ostringstream out;
+        out << random;
+        return out.str();
+    }
+    static default_random_engine parse_random(const string& text)
+    {
+        default_random_engine res;
+        istringstream(text) >> res;
+        return res;
+    }
+
+private:
+    static constexpr size_t MIN_MEDIAN = 8;   // Поисков в журнале, после которых сравнивается с медианой
+    static constexpr int MAX_FILES = 100;     // Файлов воспроизведения за запуск (на все экземпляры Logic)
+
+    bool is_slow(const double ms) const
+    {
+        if (ms < threshold_ms)
+            return false;
+        if (median_factor <= 0)
+            return threshold_ms > 0;
+        const size_t count = min(next, ring.size());
+        if (count < MIN_MEDIAN)
+            return false;
+        array<double, 256> times;
+        const size_t n = min(count, times.size());
+        for (size_t i = 0; i < n; ++i)
+            times[i] = ring[(next - 1 - i) % ring.size()].ms;
+        nth_element(times.begin(), times.begin() + n / 2, times.begin() + n);
+        return ms > median_factor * times[n / 2];
+    }
+
+    static json entry_json(const flight_entry& e)
+    {
+        return { { "position", position_text(e.mtx) }, { "color", e.color ? "b" : "w" }, { "level", e.depth },
+            { "nodes", e.nodes }, { "ms", e.ms }, { "stopped", e.stopped } };
+    }
+
+    string write_repro() const
+    {
+        static atomic<int> counter{ 0 };
+        json out = entry_json(current);
+        out["random"] = random_text(current.random);
+        out["history"] = current_history;
+        out["settings"] = settings;
+        json recent = json::array();
+        for (size_t i = min(next, ring.size()); i-- > 1;)
+            recent.push_back(entry_json(ring[(next - 1 - i) % ring.size()]));
+        out["recent"] = recent;
+
+        error_code ec;
+        filesystem::create_directories(dir, ec);
+        const auto stamp = chrono::duration_cast<chrono::milliseconds>(chrono::system_clock::now().time_since_epoch());
+        const string path = (filesystem::path(dir) / ("slow_" + to_string(stamp.count()) + "_" +
+                                                         to_string(counter.fetch_add(1)) + ".json"))
+                                .string();
+        ofstream fout(path);
+        if (!(fout << out.dump(2) << "\n"))
+            return "";
+        return path;
+    }
+
+    vector<flight_entry> ring;  // Последние поиски, next % size - место следующего
+    size_t next = 0;            // Всего поисков
+    flight_entry current;
+    vector<uint64_t> current_history;  // История партии текущего поиска (в журнал не попадает)
+    chrono::steady_clock::time_point start;
+    double threshold_ms;
+    double median_factor;
+    string dir;
+    json settings;
+    static inline atomic<int> files{ 0 };
+};
@@ -1,20 +1,39 @@
 #pragma once
+#include <atomic>
 #include <chrono>
 #include <thread>
 
 #include "../Models/Project_path.h"
+#include "Alloc_stats.h"
 #include "Board.h"
 #include "Config.h"
+#include "Draw_rule.h"
 #include "Hand.h"
+#include "Input_log.h"
+#include "Logger.h"
 #include "Logic.h"
+#include "Search_monitor.h"
+#include "Tracer.h"
 
 class Game
 {
   public:
     Game() : board(config("WindowSize", "Width"), config("WindowSize", "Hight")), hand(&board), logic(&board, &config)
     {
-        ofstream fout(project_path + "log.txt", ios_base::trunc);
-        fout.close();
+        // Журнал открывается (и очищается) при первом обращении
+        Logger::get().set_level(string(config("Log", "Level")));
+        // Трассировка пишется в файл при выходе из программы
+        if (config("Log", "Trace"))
+            Tracer::get().enable(project_path + string(config("Log", "TraceFile")));
+        // Учет выделений памяти: итоги каждой партии пишутся в журнал
+        if (config("Log", "AllocStats"))
+            Alloc_stats::enable();
+        // Запись и воспроизведение ввода повторяют партию только без случайности бота
+        if (Input_log::get().is_recording() || Input_log::get().is_playback())
+        {
+            config.set("Bot", "NoRandom", true);
+            logic = Logic(&board, &config);
+        }
     }
 
     // Основной игровой цикл - запускает и управляет игрой в шашки
@@ -22,12 +41,15 @@ class Game
     {
         // Засекаем время начала игры для записи в лог
         auto start = chrono::steady_clock::now();
+        const auto alloc_start = alloc_snapshot();
 
         // Если включен режим повтора игры, перезагружаем логику и конфигурацию
         if (is_replay)
         {
             logic = Logic(&board, &config);
             config.reload();
+            if (Input_log::get().is_recording() || Input_log::get().is_playback())
+                config.set("Bot", "NoRandom", true);
             board.redraw();
         }
         else
@@ -36,12 +58,16 @@ class Game
             board.start_draw();
         }
         is_replay = false;
+        board.keyframe_interval = config("Game", "HistoryKeyframeInterval");
 
         int turn_num = -1;           // Номер текущего хода (начинаем с -1, чтобы первый ход был 0)
         bool is_quit = false;        // Флаг выхода из игры
 
         // Максимальное количество ходов до ничьей (правило 50 ходов)
         const int Max_turns = config("Game", "MaxNumTurns");
+        // Ничья по повторению позиции и по отсутствию прогресса
+        Draw_rule draw_rule(config);
+        draw_reason draw = draw_reason::NONE;
 
         // Главный игровой цикл: продолжается пока не достигнут максимальный номер хода
         while (++turn_num < Max_turns)
@@ -55,6 +81,13 @@ class Game
             if (logic.turns.empty())
                 break;
 
+            // Позиции после отмененных ходов забываются; поиск получает серию обратимых ходов партии
+            draw_rule.truncate(size_t(turn_num));
+            draw = draw_rule.add(Logic::to_board(board.get_board()), turn_num % 2);
+            if (draw != draw_reason::NONE)
+                break;
+            logic.set_game_history(draw_rule.search_history());
+
             // Устанавливаем глубину поиска для алгоритма минимакс в зависимости от уровня сложности бота
             logic.Max_depth = config("Bot", string((turn_num % 2) ? "Black" : "White") + string("BotLevel"));
 
@@ -79,7 +112,7 @@ class Game
                 {
                     // Обработка отмены хода (возврата на ход назад)
                     if (config("Bot", string("Is") + string((1 - turn_num % 2) ? "Black" : "White") + string("Bot")) &&
-                        !beat_series && board.history_mtx.size() > 2)
+                        !beat_series && board.history_size() > 1)
                     {
                         // Если предыдущий ход был сделан ботом и не было серии ударов, отменяем два хода
                         board.rollback();
@@ -101,9 +134,12 @@ class Game
 
         // Засекаем время окончания игры и записываем длительность в лог-файл
         auto end = chrono::steady_clock::now();
-        ofstream fout(project_path + "log.txt", ios_base::app);
-        fout << "Game time: " << (int)chrono::duration<double, milli>(end - start).count() << " millisec\n";
-        fout.close();
+        Logger::get().info("Game time", { { "millisec", (int)chrono::duration<double, milli>(end - start).count() },
+                                          { "turns", turn_num } });
+        if (draw != draw_reason::NONE)
+            Logger::get().info("Draw", { { "rule", Draw_rule::name(draw) }, { "turns", turn_num } });
+        if (Alloc_stats::enabled())
+            log_alloc_stats(alloc_start, turn_num);
 
         // Если был запрос на повтор игры, запускаем play() рекурсивно
         if (is_replay)
@@ -114,9 +150,9 @@ class Game
 
         // Определяем результат игры:
         int res = 2;  // По умолчанию - победа черных (1), но изменим ниже
-        if (turn_num == Max_turns)
+        if (turn_num == Max_turns || draw != draw_reason::NONE)
         {
-            res = 0;  // Ничья (достигнут максимальный номер хода)
+            res = 0;  // Ничья (достигнут максимальный номер хода или сработало правило ничьей)
         }
         else if (turn_num % 2)
         {
@@ -145,6 +181,7 @@ class Game
       {
           // Засекаем время начала хода для записи в лог
           auto start = chrono::steady_clock::now();
+          trace_span span("bot_turn", "game", "color", color);
 
           // Получаем задержку хода бота из конфигурации (для имитации "размышления")
           auto delay_ms = config("Bot", "BotDelayMS");
@@ -153,12 +190,22 @@ class Game
           thread th(SDL_Delay, delay_ms);
 
           // Находим наилучшие ходы для бота с использованием алгоритма минимакс
-          auto turns = logic.find_best_turns(color);
+          // С панелью поиска (HUD) поиск идет в отдельном потоке, а окно перерисовывается с частотой HUD/FPS
+          vector<move_pos> turns;
+          if (config("HUD", "Enabled"))
+              turns = search_with_hud(color);
+          else
+              turns = logic.find_best_turns(color);
+          const string slow_search_file = logic.take_slow_search_file();
+          if (!slow_search_file.empty())
+              Logger::get().warning("Slow bot search", { { "file", slow_search_file }, { "nodes", logic.nodes },
+                                                         { "color", color ? "black" : "white" } });
 
           // Дожидаемся завершения потока с задержкой
           th.join();
 
           bool is_first = true;
+          bool is_first_move = true;
 
           // Выполняем найденные ходы (может быть несколько, если есть серия ударов)
           for (auto turn : turns)
@@ -173,18 +220,79 @@ class Game
               // Увеличиваем счетчик серии ударов, если ход является боем
               beat_series += (turn.xb != -1);
 
-              // Выполняем перемещение шашки на доске
+              // Выполняем перемещение шашки на доске (первый кадр - ответ бота на последний клик игрока)
+              if (is_first_move)
+                  Input_log::get().expect(latency_kind::BOT);
+              is_first_move = false;
               board.move_piece(turn, beat_series);
           }
 
           // Засекаем время окончания хода и записываем длительность в лог-файл
           auto end = chrono::steady_clock::now();
-          ofstream fout(project_path + "log.txt", ios_base::app);
-          fout << "Bot turn time: " << (int)chrono::duration<double, milli>(end - start).count() << " millisec\n";
-          fout.close();
+          Logger::get().info("Bot turn time", { { "millisec", (int)chrono::duration<double, milli>(end - start).count() },
+                                                { "color", color ? "black" : "white" } });
+#if SEARCH_STATS
+          // Одна JSON-запись со статистикой поиска на каждый ход бота
+          auto record = logic.stats.to_json();
+          record["color"] = (color ? "black" : "white");
+          Logger::get().raw(Log_level::INFO, record.dump());
+#endif
       }
     
 
+    // Поиск хода бота с панелью поиска: поток поиска публикует снимки в search_monitor, основной поток
+    // читает их и перерисовывает окно не чаще HUD/FPS раз в секунду, поэтому отрисовка не тормозит поиск
+    vector<move_pos> search_with_hud(const bool color)
+    {
+        const auto frame = chrono::microseconds(1000000 / max(1, int(config("HUD", "FPS"))));
+        logic.set_monitor(&search_monitor);
+        atomic<bool> is_done{ false };
+        vector<move_pos> res;
+        thread search_thread([&] {
+            res = logic.find_best_turns(color);
+            is_done.store(true, memory_order_release);
+        });
+        search_snapshot snapshot;
+        while (!is_done.load(memory_order_acquire))
+        {
+            const auto next_frame = chrono::steady_clock::now() + frame;
+            if (search_monitor.read(snapshot))
+                board.show_search(snapshot);
+            while (!is_done.load(memory_order_acquire) && chrono::steady_clock::now() < next_frame)
+                this_thread::sleep_for(chrono::milliseconds(2));
+        }
+        search_thread.join();
+        logic.set_monitor(nullptr);
+        // Итоговые показатели остаются на панели до следующего поиска
+        if (search_monitor.read(snapshot))
+            board.show_search(snapshot);
+        return res;
+    }
+
+    // Показывает лучшие ходы игрока color по оценке поиска (Bot/Hints ходов на глубине Bot/HintLevel)
+    // и пишет их оценки в журнал
+    void show_hints(const bool color)
+    {
+        const int count = config("Bot", "Hints");
+        if (count <= 0)
+            return;
+        const int saved_depth = logic.Max_depth;
+        logic.Max_depth = config("Bot", "HintLevel");
+        const vector<ranked_turn> hints = logic.find_ranked_turns(color, size_t(count));
+        logic.Max_depth = saved_depth;
+        for (size_t i = 0; i < hints.size(); ++i)
+        {
+            const move_pos& first = hints[i].turns.front();
+            const move_pos& last = hints[i].turns.back();
+            Logger::get().info("Hint", { { "rank", i + 1 },
+                                         { "from", first.x * 10 + first.y },
+                                         { "to", last.x2 * 10 + last.y2 },
+                                         { "captures", first.xb == -1 ? size_t(0) : hints[i].turns.size() },
+                                         { "score", hints[i].score } });
+        }
+        board.set_hints(hints);
+    }
+
     // Обрабатывает ход игрока-человека
 // Параметр color: цвет игрока (false - белые, true - черные)
 // Возвращает Response - результат действия игрока
@@ -199,7 +307,8 @@ class Game
             cells.emplace_back(turn.x, turn.y);
         }
 
-        // Подсвечиваем на доске клетки, с которых можно начать ход
+        // Подсказки и подсветка клеток, с которых можно начать ход
+        show_hints(color);
         board.highlight_cells(cells);
 
         move_pos pos = { -1, -1, -1, -1 };  // Структура для хранения выбранного хода
@@ -213,7 +322,10 @@ class Game
 
             // Если ответ не выбор клетки, возвращаем его (QUIT, REPLAY и т.д.)
             if (get<0>(resp) != Response::CELL)
+            {
+                board.clear_hints();
                 return get<0>(resp);
+            }
 
             // Получаем координаты выбранной клетки
             pair<POS_T, POS_T> cell{ get<1>(resp), get<2>(resp) };
@@ -274,14 +386,21 @@ class Game
                     cells2.emplace_back(turn.x2, turn.y2);
                 }
             }
+            Input_log::get().expect(latency_kind::HIGHLIGHT);
             board.highlight_cells(cells2);
         }
 
-        // Очищаем подсветку и выделение после завершения выбора
+        // Очищаем подсказки, подсветку и выделение после завершения выбора
+        board.clear_hints();
         board.clear_highlight();
         board.clear_active();
 
+        // Позиция перед ходом: продолжения серии проверяются по полным ходам из нее
+        const board_t start = Logic::to_board(board.get_board());
+        vector<move_pos> done = { pos };
+
         // Выполняем перемещение шашки
+        Input_log::get().expect(latency_kind::MOVE);
         board.move_piece(pos, pos.xb != -1);
 
         // Если это был простой ход (без боя), возвращаем OK
@@ -295,10 +414,10 @@ class Game
         while (true)
         {
             // Ищем возможные продолжения боя для шашки, которая только что побила
-            logic.find_turns(pos.x2, pos.y2);
+            logic.find_turns(color, start, done);
 
             // Если нет возможных ударов, завершаем серию
-            if (!logic.have_beats)
+            if (logic.turns.empty())
                 break;
 
             // Подсвечиваем клетки, куда можно бить
@@ -339,6 +458,8 @@ class Game
                 board.clear_highlight();
                 board.clear_active();
                 beat_series += 1;
+                done.push_back(pos);
+                Input_log::get().expect(latency_kind::MOVE);
                 board.move_piece(pos, beat_series);
                 break;
             }
@@ -348,10 +469,40 @@ class Game
     }
 
   private:
+    typedef array<alloc_counters, size_t(alloc_subsystem::COUNT)> alloc_totals;
+
+    // Счетчики выделений всех подсистем на текущий момент
+    static alloc_totals alloc_snapshot()
+    {
+        alloc_totals res;
+        for (size_t i = 0; i < res.size(); ++i)
+            res[i] = Alloc_stats::snapshot(alloc_subsystem(i));
+        return res;
+    }
+
+    // Записывает в журнал выделения за партию по подсистемам (всего и на ход) и память движка
+    void log_alloc_stats(const alloc_totals& start, const int turns) const
+    {
+        const alloc_totals now = alloc_snapshot();
+        for (size_t i = 0; i < now.size(); ++i)
+        {
+            const alloc_counters game = now[i] - start[i];
+            Logger::get().info("Game allocations", { { "subsystem", Alloc_stats::name(alloc_subsystem(i)) },
+                                                     { "allocations", game.allocations },
+                                                     { "bytes", game.bytes },
+                                                     { "allocations_per_move", double(game.allocations) / max(turns, 1) },
+                                                     { "bytes_per_move", double(game.bytes) / max(turns, 1) } });
+        }
+        Logger::get().info("Game memory", { { "engine_bytes", logic.memory_footprint() },
+                                            { "peak_heap_bytes", Alloc_stats::peak_heap() },
+                                            { "peak_rss_bytes", Alloc_stats::peak_rss() } });
+    }
+
     Config config;
     Board board;
     Hand hand;
     Logic logic;
+    Search_monitor search_monitor;  // Снимки поиска бота для панели HUD
     int beat_series;
     bool is_replay = false;
 };
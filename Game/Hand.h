@@ -4,6 +4,8 @@
 #include "../Models/Move.h"
 #include "../Models/Response.h"
 #include "Board.h"
+#include "Input_log.h"
+#include "Tracer.h"
 
 // Класс Hand обрабатывает пользовательский ввод (мышь, клавиатура, события окна)
 // и преобразует его в игровые команды (Response)
@@ -19,6 +21,7 @@ public:
     // Возвращает tuple: (тип ответа, координата X клетки, координата Y клетки)
     tuple<Response, POS_T, POS_T> get_cell() const
     {
+        trace_span span("get_cell", "input");  // Время ожидания действия пользователя
         SDL_Event windowEvent;  // Структура для хранения события SDL
         Response resp = Response::OK;  // Изначально предполагаем успешный ответ
         int x = -1, y = -1;     // Абсолютные координаты мыши на экране
@@ -27,8 +30,8 @@ public:
         // Бесконечный цикл ожидания события
         while (true)
         {
-            // Проверяем наличие событий в очереди SDL
-            if (SDL_PollEvent(&windowEvent))
+            // Проверяем наличие событий в очереди SDL (или следующее записанное событие при воспроизведении)
+            if (Input_log::get().poll(windowEvent, board->W, board->H))
             {
                 switch (windowEvent.type)
                 {
@@ -46,7 +49,7 @@ public:
                     yc = int(x / (board->W / 10) - 1);  // Вычисляем столбец (0-7)
 
                     // Проверка клика на кнопке "Назад" (левый верхний угол, клетка (-1, -1))
-                    if (xc == -1 && yc == -1 && board->history_mtx.size() > 1)
+                    if (xc == -1 && yc == -1 && board->history_size() > 0)
                     {
                         resp = Response::BACK;  // Кнопка "Назад" активна, если есть история ходов
                     }
@@ -91,12 +94,13 @@ public:
     // Используется после окончания игры для ожидания решения игрока
     Response wait() const
     {
+        trace_span span("wait", "input");
         SDL_Event windowEvent;
         Response resp = Response::OK;
 
         while (true)
         {
-            if (SDL_PollEvent(&windowEvent))
+            if (Input_log::get().poll(windowEvent, board->W, board->H))
             {
                 switch (windowEvent.type)
                 {
@@ -0,0 +1,233 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef __APPLE__
+#include <SDL2/SDL.h>
+#else
+#include <SDL.h>
+#endif
+
+using namespace std;
+
+// Что показывает кадр, задержка которого считается от клика
+enum class latency_kind
+{
+    HIGHLIGHT,  // Подсветка ходов выбранной шашки
+    MOVE,       // Ход игрока
+    BOT,        // Ответный ход бота
+    COUNT
+};
+
+// Структура input_event - одно записанное событие ввода
+struct input_event
+{
+    long long ms;  // Время от начала записи
+    bool is_quit;  // Закрытие окна, иначе клик мыши
+    int x, y;      // Координаты клика в окне
+};
+
+// Класс Input_log - запись и воспроизведение событий, которые читает Hand (режимы "record" и "playback")
+// Запись: каждое событие SDL, полученное Hand::get_cell и Hand::wait, с временем пишется в файл
+// Воспроизведение: события из файла подаются в игру вместо SDL_PollEvent сразу, как только игра ждет ввода,
+// поэтому при тех же настройках и NoRandom партия повторяется точно. В обоих режимах для каждого клика
+// измеряется время до показа кадра (SDL_RenderPresent) с подсветкой, ходом игрока и ответом бота
+class Input_log
+{
+public:
+    static Input_log& get()
+    {
+        static Input_log log;
+        return log;
+    }
+
+    // Начинает запись в файл path (размер окна пишется в заголовок при первом опросе)
+    bool start_record(const string& path)
+    {
+        fout.open(path, ios_base::trunc);
+        if (!fout)
+            return false;
+        mode = Mode::RECORD;
+        start = chrono::steady_clock::now();
+        return true;
+    }
+
+    // Загружает записанные события для воспроизведения
+    bool start_playback(const string& path)
+    {
+        ifstream fin(path);
+        string header;
+        if (!(fin >> header >> rec_W >> rec_H) || header != "checkers-input")
+            return false;
+        string type;
+        input_event event{};
+        while (fin >> event.ms >> type)
+        {
+            event.is_quit = type == "quit";
+            if (!event.is_quit && !(fin >> event.x >> event.y))
+                return false;
+            events.push_back(event);
+        }
+        mode = Mode::PLAYBACK;
+        return true;
+    }
+
+    bool is_recording() const
+    {
+        return mode == Mode::RECORD;
+    }
+
+    bool is_playback() const
+    {
+        return mode == Mode::PLAYBACK;
+    }
+
+    // Замена SDL_PollEvent для Hand: при воспроизведении выдает следующее записанное событие
+    // (после последнего - закрытие окна), при записи сохраняет полученное событие
+    // W, H - текущий размер окна: координаты записи пересчитываются под него
+    bool poll(SDL_Event& event, const int W, const int H)
+    {
+        if (mode == Mode::PLAYBACK)
+        {
+            event = SDL_Event{};
+            if (events.empty())
+            {
+                event.type = SDL_QUIT;
+                return true;
+            }
+            const input_event next = events.front();
+            events.pop_front();
+            if (next.is_quit)
+            {
+                event.type = SDL_QUIT;
+                return true;
+            }
+            event.type = SDL_MOUSEBUTTONDOWN;
+            event.motion.x = next.x * W / max(rec_W, 1);
+            event.motion.y = next.y * H / max(rec_H, 1);
+            on_click(chrono::steady_clock::now());
+            return true;
+        }
+
+        if (mode == Mode::RECORD && !has_header)
+        {
+            fout << "checkers-input " << W << " " << H << "\n";
+            has_header = true;
+        }
+        if (!SDL_PollEvent(&event))
+            return false;
+        if (mode == Mode::RECORD && (event.type == SDL_QUIT || event.type == SDL_MOUSEBUTTONDOWN))
+        {
+            const auto now = chrono::steady_clock::now();
+            fout << chrono::duration_cast<chrono::milliseconds>(now - start).count();
+            if (event.type == SDL_QUIT)
+            {
+                fout << " quit\n";
+            }
+            else
+            {
+                fout << " click " << event.motion.x << " " << event.motion.y << "\n";
+                // Событие могло ждать в очереди: отсчет ведем от его времени SDL
+                const Uint32 queued = SDL_GetTicks() - event.button.timestamp;
+                on_click(now - chrono::milliseconds(queued < 1000 ? queued : 0));
+            }
+            fout.flush();
+        }
+        return true;
+    }
+
+    // Следующий показанный кадр будет ответом вида kind на последний клик
+    // Для каждого клика каждый вид учитывается один раз
+    void expect(const latency_kind kind)
+    {
+        if (mode != Mode::OFF && (pending_kinds >> int(kind)) & 1)
+            expected = int(kind);
+    }
+
+    // Вызывается после SDL_RenderPresent
+    void presented()
+    {
+        if (expected < 0)
+            return;
+        const double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - click_time).count();
+        latencies[expected].push_back(ms);
+        pending_kinds &= ~(1u << expected);
+        expected = -1;
+    }
+
+    // Печатает гистограммы задержек: количество, перцентили и распределение по интервалам
+    void report() const
+    {
+        static const char* names[] = { "highlight", "move", "bot" };
+        cout << "Click-to-present latency (ms)\n";
+        for (size_t kind = 0; kind < latencies.size(); ++kind)
+        {
+            vector<double> sorted = latencies[kind];
+            sort(sorted.begin(), sorted.end());
+            cout << names[kind] << ": " << sorted.size() << " frames";
+            if (sorted.empty())
+            {
+                cout << "\n";
+                continue;
+            }
+            cout << ", p50 " << percentile(sorted, 0.5) << ", p90 " << percentile(sorted, 0.9) << ", p99 "
+                 << percentile(sorted, 0.99) << ", max " << sorted.back() << "\n";
+
+            // Интервалы по степеням двойки: [0, 1), [1, 2), [2, 4), ... [512, 1024), 1024 и больше
+            array<int, BUCKETS> buckets{};
+            for (const double ms : sorted)
+                ++buckets[min(BUCKETS - 1, ms < 1 ? 0 : int(log2(ms)) + 1)];
+            const int most = *max_element(buckets.begin(), buckets.end());
+            for (int i = 0; i < BUCKETS; ++i)
+            {
+                if (!buckets[i])
+                    continue;
+                const string range = i == 0 ? "<1" : i == BUCKETS - 1 ? ">=" + to_string(1 << (i - 1))
+                                                                      : to_string(1 << (i - 1)) + "-" + to_string(1 << i);
+                cout << "  " << range << string(max(1, 10 - int(range.size())), ' ') << string(buckets[i] * 40 / most + 1, '#')
+                     << " " << buckets[i] << "\n";
+            }
+        }
+        cout.flush();
+    }
+
+private:
+    enum class Mode
+    {
+        OFF,
+        RECORD,
+        PLAYBACK
+    };
+
+    static constexpr int BUCKETS = 12;
+
+    void on_click(const chrono::steady_clock::time_point time)
+    {
+        click_time = time;
+        pending_kinds = (1u << int(latency_kind::COUNT)) - 1;
+        expected = -1;
+    }
+
+    static double percentile(const vector<double>& sorted, const double p)
+    {
+        return sorted[min(sorted.size() - 1, size_t(p * sorted.size()))];
+    }
+
+    Mode mode = Mode::OFF;
+    ofstream fout;
+    bool has_header = false;
+    chrono::steady_clock::time_point start;
+    deque<input_event> events;
+    int rec_W = 0, rec_H = 0;                // Размер окна при записи
+    chrono::steady_clock::time_point click_time;
+    unsigned pending_kinds = 0;               // Виды ответов, еще не показанные после клика
+    int expected = -1;                        // Вид ответа следующего кадра (-1 - не учитывается)
+    array<vector<double>, size_t(latency_kind::COUNT)> latencies;
+};
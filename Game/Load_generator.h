@@ -0,0 +1,197 @@
+#pragma once
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Config.h"
+
+// Класс Load_generator - режим "loadgen": нагрузка на локальный сервер (режим "server")
+// Каждый клиент держит одно подключение и много одновременных партий, делая случайные
+// разрешенные ходы. Задержка хода бота - время от ответа человека до строки BOT/END
+class Load_generator
+{
+public:
+    // clients: число подключений, sessions: одновременных партий на подключение,
+    // games: всего партий на подключение, level: уровень бота
+    Load_generator(const int clients, const int sessions, const int games, const int level)
+        : clients(clients), sessions(sessions), games(games), level(level)
+    {
+        Config config;
+        port = config("Server", "Port");
+    }
+
+    int run()
+    {
+        auto start = chrono::steady_clock::now();
+        vector<thread> threads;
+        for (int i = 0; i < clients; ++i)
+            threads.emplace_back(&Load_generator::client, this, i);
+        for (auto& th : threads)
+            th.join();
+        const double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        sort(latencies.begin(), latencies.end());
+        auto percentile = [this](const double p) {
+            return latencies.empty() ? 0.0 : latencies[min(latencies.size() - 1, size_t(p * latencies.size()))];
+        };
+        cout << "Games finished  : " << finished << "\n";
+        cout << "Bot moves       : " << latencies.size() << "\n";
+        cout << "Busy / timeout  : " << busy << " / " << timeouts << "\n";
+        cout << "Latency p50 (ms): " << percentile(0.50) << "\n";
+        cout << "Latency p99 (ms): " << percentile(0.99) << "\n";
+        cout << "Latency max (ms): " << (latencies.empty() ? 0.0 : latencies.back()) << "\n";
+        cout << "Bot moves/second: " << (long long)(latencies.size() / max(sec, 1e-3)) << endl;
+        return (errors > 0) ? 1 : 0;
+    }
+
+private:
+    // Партия на стороне клиента
+    struct client_game
+    {
+        chrono::steady_clock::time_point sent;  // Когда передан ход боту
+    };
+
+    void client(const int index)
+    {
+        const int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(uint16_t(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (fd < 0 || connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+        {
+            cerr << "Can't connect to 127.0.0.1:" << port << endl;
+            ++errors;
+            if (fd >= 0)
+                close(fd);
+            return;
+        }
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+        mt19937 rand_eng(index);
+        unordered_map<uint64_t, client_game> active;
+        vector<double> local_latencies;
+        int started = 0, done = 0;
+        auto send_line = [fd](const string& line) {
+            const string data = line + "\n";
+            (void)!::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        };
+        // Человек играет белыми в четных партиях и черными в нечетных
+        auto new_game = [&]() {
+            send_line("NEW " + to_string(level) + ((started % 2) ? " black" : " white"));
+            ++started;
+        };
+        // Случайный ход из списка "xyx2y2,..."; после хода ждем ответа бота
+        auto random_move = [&](const uint64_t id, const string& moves) {
+            vector<string> list;
+            stringstream ss(moves);
+            string turn;
+            while (getline(ss, turn, ','))
+                list.push_back(turn);
+            active[id].sent = chrono::steady_clock::now();
+            send_line("MOVE " + to_string(id) + " " + list[rand_eng() % list.size()]);
+        };
+
+        auto pending_new = chrono::steady_clock::now();
+        for (int i = 0; i < min(sessions, games); ++i)
+            new_game();
+        string in;
+        char buf[4096];
+        while (done < games)
+        {
+            const ssize_t len = read(fd, buf, sizeof(buf));
+            if (len <= 0)
+            {
+                ++errors;
+                break;
+            }
+            in.append(buf, size_t(len));
+            size_t start = 0, end;
+            while ((end = in.find('\n', start)) != string::npos)
+            {
+                istringstream line(in.substr(start, end - start));
+                start = end + 1;
+                string cmd, board, moves;
+                uint64_t id = 0;
+                line >> cmd >> id;
+                const auto now = chrono::steady_clock::now();
+                if (cmd == "GAME")
+                {
+                    line >> board >> moves;
+                    // Если первым ходит бот, задержка считается от создания партии
+                    active[id].sent = pending_new;
+                    if (moves != "-")
+                        random_move(id, moves);
+                }
+                else if (cmd == "CONTINUE")
+                {
+                    line >> board >> moves;
+                    random_move(id, moves);
+                }
+                else if (cmd == "BOT")
+                {
+                    string turns;
+                    line >> turns >> board >> moves;
+                    local_latencies.push_back(chrono::duration<double, milli>(now - active[id].sent).count());
+                    if (moves != "-")
+                        random_move(id, moves);
+                }
+                else if (cmd == "END")
+                {
+                    active.erase(id);
+                    ++done;
+                    if (started < games)
+                    {
+                        pending_new = now;
+                        new_game();
+                    }
+                }
+                else if (cmd == "BUSY" || cmd == "TIMEOUT")
+                {
+                    (cmd == "BUSY" ? busy : timeouts)++;
+                    send_line("GO " + to_string(id));
+                }
+                else
+                {
+                    cerr << "Unexpected reply: " << line.str() << endl;
+                    ++errors;
+                }
+            }
+            in.erase(0, start);
+        }
+        close(fd);
+
+        lock_guard<mutex> lock(results_mutex);
+        latencies.insert(latencies.end(), local_latencies.begin(), local_latencies.end());
+        finished += done;
+    }
+
+    int clients;
+    int sessions;
+    int games;
+    int level;
+    int port;
+    mutex results_mutex;
+    vector<double> latencies;    // Задержки ходов бота по всем клиентам, мс
+    int finished = 0;
+    atomic<int> busy{ 0 };
+    atomic<int> timeouts{ 0 };
+    atomic<int> errors{ 0 };
+};
+#endif
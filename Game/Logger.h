@@ -0,0 +1,369 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "../Models/Project_path.h"
+
+using namespace std;
+
+// Уровни важности сообщений журнала
+enum class Log_level
+{
+    DEBUG,
+    INFO,
+    WARNING,
+    ERROR
+};
+
+// Структура log_field - одно именованное поле структурированной записи журнала (key=value)
+// Хранит значение без выделения памяти; строки должны жить до конца вызова Logger::log
+struct log_field
+{
+    enum class Kind
+    {
+        INT,
+        DOUBLE,
+        TEXT
+    };
+
+    log_field(const char* key, const long long value) : key(key), kind(Kind::INT), i(value)
+    {
+    }
+    log_field(const char* key, const int value) : log_field(key, (long long)value)
+    {
+    }
+    log_field(const char* key, const unsigned int value) : log_field(key, (long long)value)
+    {
+    }
+    log_field(const char* key, const long value) : log_field(key, (long long)value)
+    {
+    }
+    log_field(const char* key, const unsigned long value) : log_field(key, (long long)value)
+    {
+    }
+    log_field(const char* key, const unsigned long long value) : log_field(key, (long long)value)
+    {
+    }
+    log_field(const char* key, const double value) : key(key), kind(Kind::DOUBLE), d(value)
+    {
+    }
+    log_field(const char* key, const char* value) : key(key), kind(Kind::TEXT), s(value)
+    {
+    }
+    log_field(const char* key, const string& value) : key(key), kind(Kind::TEXT), s(value.c_str())
+    {
+    }
+
+    const char* key;
+    Kind kind;
+    union
+    {
+        long long i;
+        double d;
+        const char* s;
+    };
+};
+
+// Класс Logger - асинхронный буферизованный журнал log.txt
+// Игровой поток форматирует запись прямо в ячейку кольцевого буфера без блокировок,
+// а фоновый поток пишет накопленные записи в файл. При завершении программы буфер сбрасывается полностью:
+// stop() дожидается всех потоков, уже начавших запись, и только потом - последнего прохода фонового потока
+class Logger
+{
+public:
+    // Единственный журнал программы; создается и открывает файл при первом обращении
+    static Logger& get()
+    {
+        static Logger logger(project_path + "log.txt");
+        return logger;
+    }
+
+    // Минимальный уровень записываемых сообщений
+    void set_level(const Log_level new_level)
+    {
+        level.store(new_level, memory_order_relaxed);
+    }
+
+    // Устанавливает уровень по имени из settings.json ("DEBUG", "INFO", "WARNING", "ERROR")
+    void set_level(const string& name)
+    {
+        if (name == "DEBUG")
+            set_level(Log_level::DEBUG);
+        else if (name == "WARNING")
+            set_level(Log_level::WARNING);
+        else if (name == "ERROR")
+            set_level(Log_level::ERROR);
+        else
+            set_level(Log_level::INFO);
+    }
+
+    // Проверяет, будет ли записано сообщение указанного уровня
+    bool enabled(const Log_level msg_level) const
+    {
+        return msg_level >= level.load(memory_order_relaxed);
+    }
+
+    // Добавляет запись: "[LEVEL] message key=value ..."
+    void log(const Log_level msg_level, const char* message, initializer_list<log_field> fields = {})
+    {
+        if (!enabled(msg_level))
+            return;
+        producer_scope scope(*this);
+        if (!scope.admitted)
+            return;
+
+        const size_t pos = claim(1);
+        if (pos == NO_SLOT)
+            return;
+        Slot* slot = &slots[pos & (CAPACITY - 1)];
+
+        // Форматируем запись прямо в захваченную ячейку
+        size_t len = append(slot->text, 0, "[");
+        len = append(slot->text, len, level_name(msg_level));
+        len = append(slot->text, len, "] ");
+        len = append(slot->text, len, message);
+        for (const auto& field : fields)
+        {
+            len = append(slot->text, len, " ");
+            len = append(slot->text, len, field.key);
+            len = append(slot->text, len, "=");
+            char num[32];
+            switch (field.kind)
+            {
+            case log_field::Kind::INT:
+                snprintf(num, sizeof(num), "%lld", field.i);
+                len = append(slot->text, len, num);
+                break;
+            case log_field::Kind::DOUBLE:
+                snprintf(num, sizeof(num), "%g", field.d);
+                len = append(slot->text, len, num);
+                break;
+            case log_field::Kind::TEXT:
+                len = append(slot->text, len, field.s);
+                break;
+            }
+        }
+        slot->len = len;
+        slot->newline = true;
+
+        // Публикуем запись для фонового потока
+        slot->seq.store(pos + 1, memory_order_release);
+    }
+
+    // Добавляет готовую строку без префикса уровня - машиночитаемые записи (JSON статистики поиска):
+    // строка журнала, начинающаяся с '{', - целый JSON-объект. Длинная строка не обрезается,
+    // а занимает несколько ячеек подряд, которые фоновый поток пишет без перевода строки между ними
+    void raw(const Log_level msg_level, const string& line)
+    {
+        if (!enabled(msg_level))
+            return;
+        const size_t count = max<size_t>(1, (line.size() + LINE_SIZE - 1) / LINE_SIZE);
+        if (count > CAPACITY)
+            return;
+        producer_scope scope(*this);
+        if (!scope.admitted)
+            return;
+        const size_t pos = claim(count);
+        if (pos == NO_SLOT)
+            return;
+        for (size_t i = 0; i < count; ++i)
+        {
+            Slot& slot = slots[(pos + i) & (CAPACITY - 1)];
+            slot.len = min(LINE_SIZE, line.size() - i * LINE_SIZE);
+            memcpy(slot.text, line.data() + i * LINE_SIZE, slot.len);
+            slot.newline = (i + 1 == count);
+            slot.seq.store(pos + i + 1, memory_order_release);
+        }
+    }
+
+    void debug(const char* message, initializer_list<log_field> fields = {})
+    {
+        log(Log_level::DEBUG, message, fields);
+    }
+    void info(const char* message, initializer_list<log_field> fields = {})
+    {
+        log(Log_level::INFO, message, fields);
+    }
+    void warning(const char* message, initializer_list<log_field> fields = {})
+    {
+        log(Log_level::WARNING, message, fields);
+    }
+    void error(const char* message, initializer_list<log_field> fields = {})
+    {
+        log(Log_level::ERROR, message, fields);
+    }
+
+    // Дожидается записи всех уже добавленных сообщений в файл
+    void flush()
+    {
+        const size_t target = tail.load(memory_order_acquire);
+        while (written.load(memory_order_acquire) < target && running.load(memory_order_acquire))
+            this_thread::sleep_for(chrono::milliseconds(1));
+    }
+
+    // Останавливает фоновый поток, предварительно записав все сообщения
+    // Новые записи больше не принимаются; записи, которые уже начали добавлять, дописываются в файл
+    void stop()
+    {
+        if (!running.exchange(false))
+            return;
+        while (producers.load() != 0)
+            this_thread::yield();
+        drained.store(true, memory_order_release);
+        writer.join();
+    }
+
+    ~Logger()
+    {
+        stop();
+    }
+
+private:
+    static const size_t CAPACITY = 1024;   // Количество ячеек буфера (степень двойки)
+    static const size_t LINE_SIZE = 1024;  // Максимальная длина одной записи
+    static const size_t NO_SLOT = size_t(-1);  // claim: журнал остановлен, запись отброшена
+
+    // Ячейка кольцевого буфера: номер последовательности и текст записи
+    struct Slot
+    {
+        atomic<size_t> seq;
+        size_t len;
+        bool newline;  // false - запись продолжается в следующей ячейке
+        char text[LINE_SIZE];
+    };
+
+    // Поток, добавляющий запись: учитывается до повторной проверки running, чтобы stop() его дождался
+    // (обе операции последовательно согласованные: либо поток видит остановку, либо stop() видит поток).
+    // Первая, быстрая проверка не дает потокам, пишущим после остановки, держать счетчик ненулевым
+    struct producer_scope
+    {
+        explicit producer_scope(Logger& logger) : logger(logger)
+        {
+            counted = logger.running.load(memory_order_relaxed);
+            if (counted)
+                logger.producers.fetch_add(1);
+            admitted = counted && logger.running.load();
+        }
+        ~producer_scope()
+        {
+            if (counted)
+                logger.producers.fetch_sub(1, memory_order_release);
+        }
+
+        Logger& logger;
+        bool counted;
+        bool admitted;
+    };
+
+    // Захватывает count свободных ячеек подряд и возвращает позицию первой
+    // Ячейки освобождаются по порядку, поэтому достаточно проверить последнюю
+    // Если буфер заполнен, а журнал уже останавливается, запись отбрасывается (NO_SLOT)
+    size_t claim(const size_t count)
+    {
+        size_t pos = tail.load(memory_order_relaxed);
+        while (true)
+        {
+            const Slot& last = slots[(pos + count - 1) & (CAPACITY - 1)];
+            const size_t seq = last.seq.load(memory_order_acquire);
+            const long long diff = (long long)seq - (long long)(pos + count - 1);
+            if (diff == 0)
+            {
+                if (tail.compare_exchange_weak(pos, pos + count, memory_order_relaxed))
+                    return pos;
+            }
+            else if (diff < 0)
+            {
+                // Буфер заполнен: ждем, пока фоновый поток освободит место
+                if (!running.load(memory_order_relaxed))
+                    return NO_SLOT;
+                this_thread::yield();
+                pos = tail.load(memory_order_relaxed);
+            }
+            else
+            {
+                pos = tail.load(memory_order_relaxed);
+            }
+        }
+    }
+
+    explicit Logger(const string& path) : fout(path, ios_base::trunc), slots(new Slot[CAPACITY])
+    {
+        for (size_t i = 0; i < CAPACITY; ++i)
+            slots[i].seq.store(i, memory_order_relaxed);
+        writer = thread(&Logger::write_loop, this);
+    }
+
+    // Фоновый поток: переносит записи из буфера в файл, сбрасывая его при простое
+    void write_loop()
+    {
+        while (true)
+        {
+            // Читаем флаг до разбора буфера: после drained новых записей уже не будет, и этот проход последний
+            const bool is_running = !drained.load(memory_order_acquire);
+            bool any = false;
+            while (true)
+            {
+                Slot& slot = slots[head & (CAPACITY - 1)];
+                if (slot.seq.load(memory_order_acquire) != head + 1)
+                    break;
+                fout.write(slot.text, slot.len);
+                if (slot.newline)
+                    fout.put('\n');
+                slot.seq.store(head + CAPACITY, memory_order_release);
+                ++head;
+                any = true;
+            }
+            if (any)
+            {
+                fout.flush();
+                written.store(head, memory_order_release);
+            }
+            if (!is_running)
+                break;
+            if (!any)
+                this_thread::sleep_for(chrono::milliseconds(2));
+        }
+        fout.flush();
+    }
+
+    // Дописывает строку в буфер записи с обрезкой по LINE_SIZE
+    static size_t append(char* dst, size_t len, const char* src)
+    {
+        while (*src && len < LINE_SIZE)
+            dst[len++] = *src++;
+        return len;
+    }
+
+    static const char* level_name(const Log_level msg_level)
+    {
+        switch (msg_level)
+        {
+        case Log_level::DEBUG:
+            return "DEBUG";
+        case Log_level::INFO:
+            return "INFO";
+        case Log_level::WARNING:
+            return "WARNING";
+        default:
+            return "ERROR";
+        }
+    }
+
+    ofstream fout;                           // Файл журнала
+    unique_ptr<Slot[]> slots;                // Кольцевой буфер записей
+    atomic<size_t> tail{ 0 };                // Следующая позиция для записи (игровые потоки)
+    size_t head = 0;                         // Следующая позиция для чтения (фоновый поток)
+    atomic<size_t> written{ 0 };             // Сколько записей уже в файле
+    atomic<Log_level> level{ Log_level::INFO };
+    atomic<bool> running{ true };            // Записи принимаются (false - после stop())
+    atomic<int> producers{ 0 };              // Потоков, добавляющих запись прямо сейчас
+    atomic<bool> drained{ false };           // stop() дождался всех добавляющих потоков
+    thread writer;                           // Фоновый поток записи
+};
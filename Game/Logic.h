@@ -1,17 +1,40 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
 #include <random>
+#include <utility>
 #include <vector>
 
 #include "../Models/Move.h"
+#include "../Models/Ranked_turn.h"
+#include "../Models/Score.h"
+#include "../Models/Search_stats.h"
+#include "../Models/Tables.h"
+#include "../Models/Zobrist.h"
+#include "Alloc_stats.h"
+#include "Analysis_cache.h"
 #include "Board.h"
 #include "Config.h"
-
-const int INF = 1e9;  // Константа "бесконечности" для алгоритма минимакс
+#include "Flight_recorder.h"
+#include "Mcts.h"
+#include "Rules.h"
+#include "Search_monitor.h"
+#include "Tracer.h"
+#include "Tree_dump.h"
 
 // Класс Logic содержит всю игровую логику: поиск ходов, оценку позиции, алгоритм минимакс
 class Logic
 {
 public:
+    // Правила поиска бота - русские шашки; полный ход (серия взятий целиком) - один ход дерева поиска
+    typedef Rules<russian_variant> rules;
+    typedef rules::move chain_move;
+    typedef rules::move_list chain_list;
+
     // Конструктор: инициализирует логику с доской и конфигурацией
     Logic(Board* board, Config* config) : board(board), config(config)
     {
@@ -20,79 +43,472 @@ public:
             !((*config)("Bot", "NoRandom")) ? unsigned(time(0)) : 0);
         scoring_mode = (*config)("Bot", "BotScoringType");  // Режим оценки позиции
         optimization = (*config)("Bot", "Optimization");    // Уровень оптимизации алгоритма
+        potential_scoring = (scoring_mode == "NumberAndPotential");
+        pruning = (optimization != "O0");
+        selective = (optimization == "O2");
+        if (selective)
+        {
+            // Параметры выборочного поиска O2 (чем больше запасы, тем точнее и медленнее поиск)
+            lmr_min_depth = (*config)("O2", "LMRMinDepth");
+            lmr_full_moves = (*config)("O2", "LMRFullMoves");
+            futility_margin = (*config)("O2", "FutilityMargin");
+            probcut_depth = (*config)("O2", "ProbCutDepth");
+            probcut_reduction = (*config)("O2", "ProbCutReduction");
+            probcut_margin = (*config)("O2", "ProbCutMargin");
+        }
+
+        // Хеши линии поиска вместе с историей партии: история не длиннее партии (MaxNumTurns), поэтому
+        // begin_line не выделяет память (более длинная история, заданная вручную, расширит буфер один раз)
+        rep_hash.resize(size_t(max(0, int((*config)("Game", "MaxNumTurns")))) + MAX_PLY + 1);
+
+        // Поиск Монте-Карло вместо минимакса; дерево узлов создается один раз на экземпляр Logic
+        if (string((*config)("Bot", "Engine")) == "MCTS")
+        {
+            mcts_params params;
+            params.playouts_per_level = size_t(int((*config)("MCTS", "PlayoutsPerLevel")));
+            params.move_time_ms = (*config)("MCTS", "MoveTimeMS");
+            params.threads = int((*config)("MCTS", "Threads"));
+            if (params.threads == 0)
+                params.threads = max(1u, thread::hardware_concurrency());
+            params.exploration = (*config)("MCTS", "Exploration");
+            params.rollout_moves = (*config)("MCTS", "RolloutMoves");
+            params.arena_nodes = size_t(int((*config)("MCTS", "ArenaNodes")));
+            params.seed = !((*config)("Bot", "NoRandom")) ? uint64_t(time(0)) : 0;
+            mcts = make_unique<Mcts<Logic>>(params);
+        }
+
+        // Постоянный кэш результатов глубокого поиска (пустое имя файла - без кэша)
+        const string cache_file = (*config)("Cache", "File");
+        if (!cache_file.empty())
+            cache = Analysis_cache::open(project_path + cache_file);
+        cache_min_depth = (*config)("Cache", "MinDepth");
+        cache_mode = potential_scoring + 2 * (selective ? 2 : pruning);
+        // Результат O2 зависит и от его параметров: после их настройки старые записи не подходят
+        if (selective)
+        {
+            uint64_t state = 0;
+            for (const int param :
+                { lmr_min_depth, lmr_full_moves, futility_margin, probcut_depth, probcut_reduction, probcut_margin })
+            {
+                state ^= uint32_t(param);
+                cache_params = splitmix64(state);
+            }
+        }
+
+        // Дамп дерева поиска для разбора отсечений (пустое имя файла - без дампа)
+        const string dump_file = (*config)("TreeDump", "File");
+        if (!dump_file.empty())
+        {
+            if (Tree_writer* writer = Tree_writer::open(project_path + dump_file))
+                dump = make_unique<Tree_dump>(writer, (*config)("TreeDump", "MaxPly"), (*config)("TreeDump", "SamplePly"),
+                    (*config)("TreeDump", "SampleRate"));
+        }
+
+        // Журнал последних поисков с записью медленных (0 поисков - выключен)
+        const int recorded_searches = (*config)("FlightRecorder", "Searches");
+        if (recorded_searches > 0)
+        {
+            recorder = make_unique<Flight_recorder>(size_t(recorded_searches), (*config)("FlightRecorder", "ThresholdMS"),
+                (*config)("FlightRecorder", "MedianFactor"), project_path + string((*config)("FlightRecorder", "Dir")),
+                json{ { "Bot", config->section("Bot") }, { "O2", config->section("O2") },
+                    { "MCTS", config->section("MCTS") } });
+        }
     }
 
     // Находит лучшие ходы для бота с использованием алгоритма минимакс
     // color: цвет бота (false - белые, true - черные)
+    // Ходы корня берутся из turns (заполняется предыдущим вызовом find_turns(color))
     // Возвращает вектор ходов, которые должен сделать бот (может быть несколько, если есть серия ударов)
     vector<move_pos> find_best_turns(const bool color)
     {
-        // Очищаем вспомогательные структуры для хранения лучших ходов и состояний
-        next_best_state.clear();
-        next_move.clear();
+        // Ходы корня переносим в список фиксированной вместимости
+        move_list root_turns;
+        for (const auto& turn : turns)
+            root_turns.push_back(packed_move(turn));
+        root_turns.have_beats = have_beats;
 
-        // Запускаем поиск лучшего хода с начального состояния
-        // Параметры: текущее состояние доски, цвет бота, координаты (-1, -1) - нет активной шашки,
-        // состояние 0 (начальное), альфа = -1 (начальное значение для максимизирующего игрока)
-        find_first_best_turn(board->get_board(), color, -1, -1, 0);
+        return search_root(to_board(board->get_board()), color, root_turns);
+    }
 
-        // Восстанавливаем цепочку лучших ходов из вспомогательных структур
-        int cur_state = 0;
-        vector<move_pos> res;
-        do
+    // Находит лучшие ходы для бота в переданной позиции (без использования доски Board)
+    // mtx: позиция, color: цвет бота
+    vector<move_pos> find_best_turns(const board_t& mtx, const bool color)
+    {
+        move_list root_turns;
+        find_turns(color, mtx, root_turns);
+        return search_root(mtx, color, root_turns);
+    }
+
+    // Многолинейный поиск: count лучших ходов корня с точными оценками и главными линиями, лучшие первыми
+    // Оценки точные только для возвращенных ходов: граница для остальных - оценка count-го лучшего хода,
+    // поэтому ходы хуже нее отсекаются так же быстро, как в обычном поиске. Всегда используется минимакс
+    // count не больше MAX_RANKED_TURNS. Лучшие линии хранятся в таблице, выделяемой при первом вызове;
+    // память выделяется только под возвращаемый результат
+    vector<ranked_turn> find_ranked_turns(const board_t& mtx, const bool color, size_t count)
+    {
+        trace_span span("find_ranked_turns", "search", "depth", Max_depth);
+        alloc_scope scope(alloc_subsystem::SEARCH);
+        nodes = 0;
+        stopped = false;
+        if (selective)
+            history = {};
+
+        if (!ranked)
+            ranked = make_unique<ranked_table>();
+        count = min(count, size_t(MAX_RANKED_TURNS));
+        // Лучшие ходы по убыванию оценки: order - номера строк таблицы ranked, не больше count
+        array<int, MAX_RANKED_TURNS> order;
+        size_t found = 0;
+
+        if (dump)
+        {
+            dump->begin_search();
+            dump->enter(0, Max_depth + 1, 0, -SCORE_INF, SCORE_INF, nodes);
+        }
+        ++nodes;
+        move_frame frame(*this);
+        chain_list& turns_now = *frame.moves;
+        find_chains(color, mtx, turns_now);
+        if (dump)
+            dump->set_moves(turns_now.size);
+        begin_line();
+        for (const chain_move& turn : turns_now)
+        {
+            // Граница - оценка худшего из уже найденных count ходов: ход ниже нее в результат не попадет
+            const int alpha = found < count ? -SCORE_INF : (*ranked)[order[found - 1]].score;
+            if (dump)
+                dump->set_move(turn.from, turn.to, turn.count, nodes);
+            const board_t next = rules::make_move(mtx, turn);
+            int score = SCORE_DRAW;
+            if (repeats_line(mtx, color, 0, turn, next))
+                pv_len[1] = 1;
+            else
+                score = find_best_turns_rec(next, !color, 0, 1, alpha);
+            if (stopped)
+                break;
+            if (score <= alpha)
+                continue;
+
+            // Новая строка - свободная или вытесняемого худшего хода; главная линия ответа лежит в строке 1
+            // таблицы pv
+            const int row = found < count ? int(found++) : order[found - 1];
+            ranked_line& line = (*ranked)[row];
+            line.turn = turn;
+            line.score = score;
+            line.pv_len = max(pv_len[1], 1) - 1;
+            copy((*pv)[1].begin() + 1, (*pv)[1].begin() + 1 + line.pv_len, line.pv.begin());
+            size_t pos = found - 1;
+            for (; pos > 0 && (*ranked)[order[pos - 1]].score < score; --pos)
+                order[pos] = order[pos - 1];
+            order[pos] = row;
+        }
+        if (dump)
         {
-            // Добавляем лучший ход из текущего состояния
-            res.push_back(next_move[cur_state]);
-            // Переходим к следующему состоянию (для серии ударов)
-            cur_state = next_best_state[cur_state];
-        } while (cur_state != -1 && next_move[cur_state].x != -1); // Пока есть следующие ходы
+            dump->leave(found == 0 ? -SCORE_INF : (*ranked)[order[0]].score, nodes);
+            dump->end_search();
+        }
 
+        vector<ranked_turn> res(found);
+        for (size_t i = 0; i < found; ++i)
+        {
+            const ranked_line& line = (*ranked)[order[i]];
+            res[i].turns = to_move_pos_list(line.turn);
+            res[i].score = line.score;
+            for (int j = 0; j < line.pv_len; ++j)
+                res[i].pv.push_back(to_move_pos_list(line.pv[j]));
+        }
         return res;
     }
 
+    // Многолинейный поиск в позиции доски Board
+    vector<ranked_turn> find_ranked_turns(const bool color, const size_t count)
+    {
+        return find_ranked_turns(to_board(board->get_board()), color, count);
+    }
+
+    // Задает ограничения для следующих поисков (используется сервером)
+    // cancel_flag: флаг отмены - поиск прерывается сразу, результат не нужен
+    // time_limit: крайний срок - поиск прерывается после полного просмотра первого хода корня
+    // и возвращает лучший из уже просмотренных ходов
+    void set_limits(const atomic<bool>* cancel_flag, const chrono::steady_clock::time_point time_limit)
+    {
+        cancel = cancel_flag;
+        deadline = time_limit;
+        has_limits = true;
+    }
+
+    // Снимает ограничения поиска
+    void clear_limits()
+    {
+        cancel = nullptr;
+        has_limits = false;
+    }
+
+    // Был ли последний поиск прерван по отмене или крайнему сроку
+    bool is_stopped() const
+    {
+        return stopped;
+    }
+
+    // Повторяет поиск из файла воспроизведения Flight_recorder: позиция mtx, ход color и состояние генератора
+    // случайных чисел random до поиска (порядок ходов минимакса тот же, поэтому тот же и результат)
+    vector<move_pos> replay_search(const board_t& mtx, const bool color, const default_random_engine& random)
+    {
+        move_list root_turns;
+        generate_turns(color, mtx, root_turns);
+        rand_eng = random;
+        return search_root(mtx, color, root_turns);
+    }
+
+    // История партии для поиска повторений: хеши позиций (position_hash) серии обратимых ходов перед текущей
+    // позицией, от старых к новым (Draw_rule::search_history). Ход в позицию из истории или из текущей линии
+    // поиска считается ничьей и дальше не просматривается
+    void set_game_history(vector<uint64_t> hashes)
+    {
+        game_history = move(hashes);
+    }
+
+    // Подключает панель поиска: поиски find_best_turns публикуют в monitor глубину, узлы, оценку и главную
+    // линию (nullptr - отключить)
+    void set_monitor(Search_monitor* search_monitor)
+    {
+        monitor = search_monitor;
+    }
+
+    // Путь к файлу воспроизведения, записанному последним поиском (пустая строка - поиск не был медленным)
+    // Путь выдается один раз
+    string take_slow_search_file()
+    {
+        return exchange(slow_search_file, string());
+    }
+
+    // Память, постоянно занятая движком: сам объект (история O2), таблица главных линий, списки ходов, хеши линии,
+    // линии многолинейного поиска и дерево MCTS
+    size_t memory_footprint() const
+    {
+        return sizeof(Logic) + sizeof(pv_table) + move_stack.size() * sizeof(chain_list) +
+            rep_hash.capacity() * sizeof(uint64_t) + (ranked ? sizeof(ranked_table) : 0) + (mcts ? mcts->memory() : 0);
+    }
+
 private:
-    // Выполняет ход на переданной матрице доски и возвращает новое состояние
+    // Запускает поиск с корня; при включенном FlightRecorder поиск попадает в журнал
+    vector<move_pos> search_root(const board_t& mtx, const bool color, const move_list& root_turns)
+    {
+        if (monitor)
+            monitor_begin(mtx, color);
+        if (recorder)
+            recorder->begin(mtx, color, Max_depth, rand_eng, game_history);
+        vector<move_pos> res = run_search(mtx, color, root_turns);
+        if (recorder)
+            slow_search_file = recorder->end(nodes, stopped);
+        if (monitor)
+            monitor_end();
+        return res;
+    }
+
+    // Начало поиска для панели: оценки и главной линии еще нет
+    // Ходов корня столько же, сколько полных ходов перебирает поиск (monitor_root_move считает их же)
+    void monitor_begin(const board_t& mtx, const bool color)
+    {
+        move_frame frame(*this);
+        rules::generate(mtx, color, *frame.moves);
+        progress = search_snapshot();
+        progress.start_ticks = chrono::steady_clock::now().time_since_epoch().count();
+        progress.depth = Max_depth;
+        progress.root_moves = int(frame.moves->size);
+        progress.color = color;
+        progress.running = true;
+        monitor->publish(progress);
+    }
+
+    // Ход корня просмотрен; improved - он стал лучшим, оценка и главная линия обновились
+    void monitor_root_move(const int root_move, const bool improved, const int score)
+    {
+        progress.nodes = nodes;
+        progress.root_move = root_move;
+        if (improved)
+        {
+            progress.score = score;
+            progress.has_score = true;
+            progress.segments = 0;
+            for (int i = 0; i < pv_len[0]; ++i)
+            {
+                const chain_move& turn = (*pv)[0][i];
+                POS_T pos = turn.from;
+                for (int hop = 0; hop < max<int>(turn.count, 1); ++hop)
+                {
+                    if (progress.segments == search_snapshot::MAX_SEGMENTS)
+                        break;
+                    const POS_T to = turn.count ? turn.path[hop] : turn.to;
+                    progress.pv[progress.segments++] = { uint8_t(pos), uint8_t(to), uint8_t(i) };
+                    pos = to;
+                }
+            }
+        }
+        monitor->publish(progress);
+    }
+
+    // Конец поиска: итоговые узлы и время
+    void monitor_end()
+    {
+        progress.nodes = nodes;
+        progress.running = false;
+        progress.elapsed_ms = chrono::duration<double, milli>(
+            chrono::steady_clock::now().time_since_epoch() - chrono::steady_clock::duration(progress.start_ticks))
+                                  .count();
+        monitor->publish(progress);
+    }
+
+    // Выполняет поиск с корня и восстанавливает цепочку ходов бота из главной линии
+    vector<move_pos> run_search(const board_t& mtx, const bool color, const move_list& root_turns)
+    {
+        trace_span span("find_best_turns", "search", "depth", Max_depth);
+        alloc_scope scope(alloc_subsystem::SEARCH);
+        nodes = 0;
+        stopped = false;
+        if (mcts)
+        {
+            const vector<move_pos> res = mcts->search(mtx, color, Max_depth, has_limits ? cancel : nullptr,
+                has_limits ? deadline : chrono::steady_clock::time_point::max());
+            nodes = mcts->playouts();
+            stopped = mcts->is_stopped();
+            return res;
+        }
+        if (selective)
+            history = {};
+        STATS_ONLY(stats.clear(); stats.max_depth = Max_depth;)
+        STATS_ONLY(stats_timer total_timer(stats.total_ns);)
+
+        // Результат глубокого поиска мог быть сохранен в кэше в прошлых сессиях
+        // С историей партии результат зависит от пути к позиции - такой поиск кэш не использует
+        const bool use_cache = cache && game_history.empty() && Max_depth >= cache_min_depth && Max_depth < 64;
+        const uint64_t key = use_cache ? cache_key(mtx, color) : 0;
+        vector<move_pos> res;
+        if (use_cache && find_cached(key, root_turns, res))
+            return res;
+
+        // Запускаем поиск лучшего хода с начального состояния
+        if (dump)
+            dump->begin_search();
+        const int score = find_first_best_turn(mtx, color);
+        if (dump)
+            dump->end_search();
+
+        // Первый ход главной линии - ход бота (вся серия взятий), раскладываем его на отдельные удары
+        if (pv_len[0] > 0)
+            res = to_move_pos_list((*pv)[0][0]);
+
+        // Результат прерванного поиска неполный и в кэш не попадает
+        if (use_cache && !stopped && !res.empty() && res.size() <= size_t(cache_record::MAX_TURNS))
+        {
+            cache_record rec;
+            rec.key = key;
+            rec.score = int16_t(score);
+            rec.depth = uint8_t(Max_depth);
+            rec.count = uint8_t(res.size());
+            for (size_t i = 0; i < res.size(); ++i)
+                rec.turns[i] = packed_move(res[i]).data;
+            cache->store(rec);
+        }
+        return res;
+    }
+
+    // Ключ кэша: позиция, очередь хода, глубина и режим поиска (от них зависит результат)
+    uint64_t cache_key(const board_t& mtx, const bool color) const
+    {
+        return position_hash(mtx, color) ^ ZOBRIST.depth[Max_depth] ^ ZOBRIST.mode[cache_mode] ^ cache_params;
+    }
+
+    // Берет серию ходов из кэша; первый ход проверяется по списку ходов корня
+    bool find_cached(const uint64_t key, const move_list& root_turns, vector<move_pos>& res)
+    {
+        cache_record rec;
+        if (!cache->find(key, rec) || rec.depth != Max_depth || rec.count == 0 || rec.count > cache_record::MAX_TURNS)
+            return false;
+        packed_move turn;
+        turn.data = rec.turns[0];
+        if (find(root_turns.begin(), root_turns.end(), turn) == root_turns.end())
+            return false;
+        res.reserve(rec.count);
+        for (int i = 0; i < rec.count; ++i)
+        {
+            turn.data = rec.turns[i];
+            res.push_back(turn.to_move_pos());
+        }
+        return true;
+    }
+
+    // Проверяет отмену и крайний срок (вызывается раз в 1024 узла)
+    bool check_limits() const
+    {
+        if (cancel && cancel->load(memory_order_relaxed))
+            return true;
+        return pv_len[0] > 0 && chrono::steady_clock::now() >= deadline;
+    }
+
+public:
+    // Выполняет ход на переданной доске и возвращает новое состояние
     // mtx: текущее состояние доски
     // turn: ход для выполнения
     // Возвращает новое состояние доски после хода
-    vector<vector<POS_T>> make_turn(vector<vector<POS_T>> mtx, move_pos turn) const
+    static board_t make_turn(board_t mtx, const packed_move turn)
     {
         // Если ход включает бой, удаляем побитую шашку
-        if (turn.xb != -1)
-            mtx[turn.xb][turn.yb] = 0;
+        if (turn.is_beat())
+            mtx[turn.beaten()] = 0;
 
         // Проверяем превращение в дамку
-        if ((mtx[turn.x][turn.y] == 1 && turn.x2 == 0) || (mtx[turn.x][turn.y] == 2 && turn.x2 == 7))
-            mtx[turn.x][turn.y] += 2;
+        const POS_T x2 = TABLES.row[turn.to()];
+        if ((mtx[turn.from()] == 1 && x2 == 0) || (mtx[turn.from()] == 2 && x2 == 7))
+            mtx[turn.from()] += 2;
 
         // Перемещаем шашку
-        mtx[turn.x2][turn.y2] = mtx[turn.x][turn.y];
-        mtx[turn.x][turn.y] = 0;
+        mtx[turn.to()] = mtx[turn.from()];
+        mtx[turn.from()] = 0;
         return mtx;
     }
 
+    // Хеш Зобриста позиции с учетом очереди хода
+    static uint64_t position_hash(const board_t& mtx, const bool color)
+    {
+        uint64_t res = color ? ZOBRIST.black_turn : 0;
+        for (POS_T cell = 0; cell < 32; ++cell)
+            res ^= ZOBRIST.piece[cell][mtx[cell]];
+        return res;
+    }
+
+    // Переводит матрицу доски 8x8 в состояние для поиска
+    static board_t to_board(const vector<vector<POS_T>>& mtx)
+    {
+        board_t res;
+        for (POS_T cell = 0; cell < 32; ++cell)
+            res[cell] = mtx[dark_cell_x(cell)][dark_cell_y(cell)];
+        return res;
+    }
+
+private:
     // Оценивает позицию на доске с точки зрения указанного игрока
     // mtx: состояние доски для оценки
     // first_bot_color: цвет бота, для которого вычисляется оценка (false - белые, true - черные)
-    // Возвращает числовую оценку позиции (чем выше, тем лучше для first_bot_color)
-    double calc_score(const vector<vector<POS_T>>& mtx, const bool first_bot_color) const
+    // ply: расстояние от корня (для оценки выигрыша и проигрыша)
+    // Возвращает оценку позиции в сотых долях шашки (чем выше, тем лучше для first_bot_color)
+    int calc_score(const board_t& mtx, const bool first_bot_color, const int ply) const
     {
         // color - who is max player
-        double w = 0, wq = 0, b = 0, bq = 0;
-        for (POS_T i = 0; i < 8; ++i)
+        int w = 0, wq = 0, b = 0, bq = 0;
+        int w_potential = 0, b_potential = 0;
+        for (POS_T cell = 0; cell < 32; ++cell)
         {
-            for (POS_T j = 0; j < 8; ++j)
+            const POS_T i = TABLES.row[cell];
+            w += (mtx[cell] == 1);
+            wq += (mtx[cell] == 3);
+            b += (mtx[cell] == 2);
+            bq += (mtx[cell] == 4);
+            if (potential_scoring)
             {
-                w += (mtx[i][j] == 1);
-                wq += (mtx[i][j] == 3);
-                b += (mtx[i][j] == 2);
-                bq += (mtx[i][j] == 4);
-                if (scoring_mode == "NumberAndPotential")
-                {
-                    // Дополнительная оценка: шашки ближе к дамочному полю получают бонус
-                    w += 0.05 * (mtx[i][j] == 1) * (7 - i);  // Белые шашки: чем ближе к верху (превращение), тем лучше
-                    b += 0.05 * (mtx[i][j] == 2) * (i);      // Черные шашки: чем ближе к низу, тем лучше
-                }
+                // Дополнительная оценка: шашки ближе к дамочному полю получают бонус
+                w_potential += 5 * (mtx[cell] == 1) * (7 - i);  // Белые шашки: чем ближе к верху (превращение), тем лучше
+                b_potential += 5 * (mtx[cell] == 2) * (i);      // Черные шашки: чем ближе к низу, тем лучше
             }
         }
         // Если бот играет черными, меняем местами оценки
@@ -100,153 +516,294 @@ private:
         {
             swap(b, w);
             swap(bq, wq);
+            swap(b_potential, w_potential);
         }
-        // Если у противника не осталось шашек - максимальная оценка (победа)
+        // Если у противника не осталось шашек - победа на этом ходу
         if (w + wq == 0)
-            return INF;
-        // Если у бота не осталось шашек - минимальная оценка (поражение)
+            return SCORE_WIN - ply;
+        // Если у бота не осталось шашек - поражение на этом ходу
         if (b + bq == 0)
-            return 0;
+            return -SCORE_WIN + ply;
 
         // Коэффициент ценности дамки (обычно дамка ценнее обычной шашки)
         int q_coef = 4;
-        if (scoring_mode == "NumberAndPotential")
+        if (potential_scoring)
         {
             q_coef = 5;
         }
-        // Формула оценки: (шашки бота + дамки бота * коэффициент) / (шашки противника + дамки противника * коэффициент)
-        return (b + bq * q_coef) / (w + wq * q_coef);
+        // Формула оценки: разница материала (шашки + дамки * коэффициент) в сотых долях шашки
+        return 100 * ((b + bq * q_coef) - (w + wq * q_coef)) + b_potential - w_potential;
     }
 
-    // Находит лучший первый ход для текущей позиции (входная точка алгоритма минимакс)
-    // mtx: текущее состояние доски
-    // color: цвет бота (для которого ищем лучший ход)
-    // x, y: координаты шашки, которая должна продолжить ход (если есть серия ударов)
-    // state: текущий индекс состояния в вспомогательных массивах
-    // alpha: лучшая оценка для максимизирующего игрока (для альфа-бета отсечения)
-    // Возвращает оценку лучшего хода
-    double find_first_best_turn(vector<vector<POS_T>> mtx, const bool color, const POS_T x, const POS_T y, size_t state,
-        double alpha = -1)
+    // Список ходов узла из стека move_stack: занимается при входе в узел и освобождается при выходе
+    // Проверочный поиск ProbCut идет в той же позиции, поэтому списки нумеруются вложенностью вызовов, а не ply
+    struct move_frame
     {
-        // Добавляем новое состояние в вспомогательные массивы
-        next_best_state.push_back(-1); // Пока не знаем следующее лучшее состояние
-        next_move.emplace_back(-1, -1, -1, -1); // Пока не знаем лучший ход
+        explicit move_frame(Logic& logic) : logic(logic)
+        {
+            if (size_t(logic.frames) == logic.move_stack.size())
+                logic.move_stack.emplace_back();
+            moves = &logic.move_stack[logic.frames++];
+        }
+        ~move_frame()
+        {
+            --logic.frames;
+        }
 
-        double best_score = -1; // Лучшая оценка для текущего состояния
+        Logic& logic;
+        chain_list* moves;
+    };
 
-        // Если это не начальное состояние (state != 0), ищем ходы для конкретной шашки
-        // (это нужно для продолжения серии ударов)
-        if (state != 0)
-            find_turns(x, y, mtx);
+    // Сохраняет ход turn и продолжение из строки ply + 1 как главную линию узла ply
+    void update_pv(const int ply, const chain_move& turn)
+    {
+        (*pv)[ply][ply] = turn;
+        for (int i = ply + 1; i < pv_len[ply + 1]; ++i)
+            (*pv)[ply][i] = (*pv)[ply + 1][i];
+        pv_len[ply] = max(pv_len[ply + 1], ply + 1);
+    }
 
-        auto turns_now = turns; // Копируем найденные ходы
-        bool have_beats_now = have_beats; // Запоминаем, есть ли среди них взятия
+    // Находит лучший ход бота в корне (входная точка алгоритма минимакс)
+    // mtx: текущее состояние доски
+    // color: цвет бота (для которого ищем лучший ход)
+    // Серия взятий - один ход, поэтому в корне сразу ходит бот, а в узлах глубины 0 - соперник
+    // Возвращает оценку лучшего хода
+    int find_first_best_turn(const board_t& mtx, const bool color)
+    {
+        if (dump)
+            dump->enter(0, Max_depth + 1, 0, -SCORE_INF, SCORE_INF, nodes);
+        ++nodes;
+        STATS_ONLY(stats.add_node(0);)
+        pv_len[0] = 0;
 
-        // Если нет обязательных ударов и это не начальное состояние,
-        // переходим к рекурсивному поиску для следующего игрока
-        if (!have_beats_now && state != 0)
+        move_frame frame(*this);
+        chain_list& turns_now = *frame.moves;
         {
-            return find_best_turns_rec(mtx, 1 - color, 0, alpha);
+            STATS_ONLY(stats_timer timer(stats.movegen_ns);)
+            find_chains(color, mtx, turns_now);
         }
+        if (dump)
+            dump->set_moves(turns_now.size);
+        begin_line();
 
-        // Перебираем все возможные ходы в текущем состоянии
-        for (auto turn : turns_now)
+        int best_score = -SCORE_INF; // Лучшая оценка для текущего состояния
+        int root_move = 0;
+        for (const chain_move& turn : turns_now)
         {
-            size_t next_state = next_move.size(); // Индекс следующего состояния
+            // Интервал трассировки на поддерево каждого хода корня (move = x y x2 y2 в десятичных разрядах)
+            trace_span span("root_move", "search", "move",
+                dark_cell_x(turn.from) * 1000 + dark_cell_y(turn.from) * 100 + dark_cell_x(turn.to) * 10 +
+                    dark_cell_y(turn.to));
+            STATS_ONLY(stats.max_chain = max(stats.max_chain, int(turn.count)); stats.chain_nodes += (turn.count > 1);)
+            if (dump)
+                dump->set_move(turn.from, turn.to, turn.count, nodes);
 
-            double score;
-            if (have_beats_now)
-            {
-                // Если есть взятия, продолжаем серию ударов (ходит тот же игрок)
-                score = find_first_best_turn(make_turn(mtx, turn), color, turn.x2, turn.y2, next_state, best_score);
-            }
+            const board_t next = rules::make_move(mtx, turn);
+            int score = SCORE_DRAW;
+            if (repeats_line(mtx, color, 0, turn, next))
+                pv_len[1] = 1;
             else
-            {
-                // Если нет взятий, переходим к следующему игроку
-                score = find_best_turns_rec(make_turn(mtx, turn), 1 - color, 0, best_score);
-            }
+                score = find_best_turns_rec(next, !color, 0, 1, best_score);
+            // Оценка прерванного поиска недостоверна
+            if (stopped)
+                break;
 
-            // Если нашли ход с лучшей оценкой, обновляем лучший ход и оценку
-            if (score > best_score)
+            // Если нашли ход с лучшей оценкой, обновляем лучший ход и главную линию
+            const bool improved = score > best_score || pv_len[0] == 0;
+            if (improved)
             {
-                best_score = score;
-                // Запоминаем следующее состояние (если есть серия ударов) или -1
-                next_best_state[state] = (have_beats_now ? int(next_state) : -1);
-                // Запоминаем лучший ход для текущего состояния
-                next_move[state] = turn;
+                best_score = max(best_score, score);
+                update_pv(0, turn);
             }
+            if (monitor)
+                monitor_root_move(++root_move, improved, best_score);
         }
 
+        if (dump)
+        {
+            if (stopped)
+                dump->set_cut(tree_cut::STOPPED);
+            dump->leave(best_score, nodes);
+        }
         return best_score;
     }
 
+    // Начало линии поиска: до корня идет серия обратимых ходов партии (set_game_history)
+    void begin_line()
+    {
+        rep_base = game_history.size();
+        if (rep_hash.size() < rep_base + MAX_PLY + 1)
+            rep_hash.resize(rep_base + MAX_PLY + 1);
+        copy(game_history.begin(), game_history.end(), rep_hash.begin());
+        line_run[0] = int(rep_base);
+        hash_known[0] = false;
+    }
+
+    // Проверяет ход turn из узла линии ply (позиция mtx, ходит color), next - позиция после хода
+    // Повториться может только позиция после тихого хода дамки: хеш ребенка считается по хешу узла
+    // несколькими XOR и сравнивается с позициями того же цвета хода в серии обратимых ходов
+    // Возвращает true, если позиция next уже была в линии или в истории партии
+    bool repeats_line(const board_t& mtx, const bool color, const int ply, const chain_move& turn, const board_t& next)
+    {
+        if (turn.count != 0 || mtx[turn.from] < 3)
+        {
+            // Взятие или ход простой шашкой необратимы: с ребенка начинается новая серия
+            line_run[ply + 1] = 0;
+            hash_known[ply + 1] = false;
+            return false;
+        }
+        if (!hash_known[ply])
+        {
+            rep_hash[rep_base + ply] = position_hash(mtx, color);
+            hash_known[ply] = true;
+        }
+        const uint64_t hash = rep_hash[rep_base + ply] ^ ZOBRIST.black_turn ^ ZOBRIST.piece[turn.from][mtx[turn.from]] ^
+                              ZOBRIST.piece[turn.to][next[turn.to]];
+        const int run = line_run[ply] + 1;
+        line_run[ply + 1] = run;
+        hash_known[ply + 1] = true;
+        rep_hash[rep_base + ply + 1] = hash;
+        // Позиция повторяется не раньше, чем через 4 хода (каждая сторона ходит туда и обратно)
+        for (int back = 4; back <= run; back += 2)
+        {
+            if (rep_hash[rep_base + ply + 1 - back] == hash)
+                return true;
+        }
+        return false;
+    }
+
+    // Записывает узел в дамп дерева: открывает запись и повторно вызывает find_best_turns_rec для перебора
+    int dump_node(const board_t& mtx, const bool color, const size_t depth, const int ply, const int alpha,
+        const int beta, const int reduced)
+    {
+        dump->enter(ply, Max_depth - int(depth) - reduced, reduced, alpha, beta, nodes);
+        dump_entered = true;
+        const int score = find_best_turns_rec(mtx, color, depth, ply, alpha, beta, reduced);
+        dump->leave(score, nodes);
+        return score;
+    }
+
     // Рекурсивная функция алгоритма минимакс с альфа-бета отсечением
     // mtx: текущее состояние доски
     // color: цвет текущего игрока (false - белые, true - черные)
     // depth: текущая глубина рекурсии (0 - начало)
-    // alpha: лучшая оценка для максимизирующего игрока (начальное значение -1)
-    // beta: лучшая оценка для минимизирующего игрока (начальное значение INF+1)
-    // x, y: координаты шашки, которая должна продолжить ход (для серии ударов)
+    // ply: номер строки таблицы главной линии
+    // alpha: лучшая оценка для максимизирующего игрока (начальное значение -SCORE_INF)
+    // beta: лучшая оценка для минимизирующего игрока (начальное значение SCORE_INF)
+    // reduced: на сколько ходов сокращена глубина этой ветки (только O2)
     // Возвращает оценку позиции для текущего игрока
-    double find_best_turns_rec(vector<vector<POS_T>> mtx, const bool color, const size_t depth, double alpha = -1,
-        double beta = INF + 1, const POS_T x = -1, const POS_T y = -1)
+    int find_best_turns_rec(const board_t& mtx, const bool color, const size_t depth, const int ply,
+        int alpha = -SCORE_INF, int beta = SCORE_INF, const int reduced = 0)
     {
-        // Базовый случай рекурсии: достигнута максимальная глубина поиска
-        if (depth == Max_depth)
+        // Узел дампа дерева открывает dump_node, который вызывает эту функцию повторно
+        if (dump && !exchange(dump_entered, false))
+            return dump_node(mtx, color, depth, ply, alpha, beta, reduced);
+        ++nodes;
+        STATS_ONLY(stats.add_node(depth + 1);)
+        pv_len[ply] = ply;
+        // Ограничения проверяем редко, чтобы не замедлять поиск
+        if (has_limits && !stopped && (nodes & 1023) == 0)
+            stopped = check_limits();
+        if (monitor && (nodes & 4095) == 0)
+            monitor->set_nodes(nodes);
+        if (stopped)
         {
-            // Оцениваем позицию с точки зрения игрока, который должен был ходить на этой глубине
-            return calc_score(mtx, (depth % 2 == color));
+            if (dump)
+                dump->set_cut(tree_cut::STOPPED);
+            return 0;
         }
-
-        // Если заданы координаты шашки, ищем ходы только для нее (продолжение серии ударов)
-        if (x != -1)
+        // Быстрее, чем на следующем ходу, не выиграть и не проиграть: если граница уже не хуже,
+        // этот узел результат не изменит (оценки выигрыша зависят от расстояния до корня)
+        if (depth % 2 ? SCORE_WIN - (ply + 1) <= alpha : -SCORE_WIN + (ply + 1) >= beta)
         {
-            find_turns(x, y, mtx);
+            if (dump)
+                dump->set_cut(tree_cut::MATE_DISTANCE);
+            return depth % 2 ? alpha : beta;
         }
-        else // Иначе ищем все ходы для текущего цвета
+        // Базовый случай рекурсии: достигнута максимальная глубина поиска
+        const int remaining = Max_depth - int(depth) - reduced;  // Сколько ходов осталось до листьев
+        // В O2 позиция с обязательным взятием не оценивается, пока размен не закончится
+        if ((remaining <= 0 && !(selective && has_beats(mtx, color))) || ply + 1 >= MAX_PLY)
         {
-            find_turns(color, mtx);
+            // Оцениваем позицию с точки зрения игрока, который должен был ходить на этой глубине
+            STATS_ONLY(++stats.leaf_evals; stats_timer timer(stats.eval_ns);)
+            if (dump)
+                dump->set_cut(tree_cut::LEAF);
+            return calc_score(mtx, (depth % 2 == color), ply);
         }
 
-        auto turns_now = turns; // Копируем найденные ходы
-        bool have_beats_now = have_beats; // Запоминаем, есть ли взятия
-
-        // Если нет обязательных ударов и была задана конкретная шашка,
-        // значит серия ударов закончилась - переходим к ходу следующего игрока
-        if (!have_beats_now && x != -1)
+        // Ищем все ходы текущего игрока (серии взятий - целиком)
+        move_frame frame(*this);
+        chain_list& turns_now = *frame.moves;
         {
-            return find_best_turns_rec(mtx, 1 - color, depth + 1, alpha, beta);
+            STATS_ONLY(stats_timer timer(stats.movegen_ns);)
+            find_chains(color, mtx, turns_now);
         }
+        const bool have_beats = !turns_now.empty() && turns_now.items[0].count > 0;
+        if (dump)
+            dump->set_moves(turns_now.size);
 
         // Если нет доступных ходов - терминальное состояние игры
-        if (turns.empty())
+        if (turns_now.empty())
         {
+            if (dump)
+                dump->set_cut(tree_cut::NO_MOVES);
             // Если на глубине depth ходит текущий игрок (depth % 2 == 0 для максимизирующего),
-            // то у него нет ходов - это проигрышная позиция (оценка 0 для минимизирующего, INF для максимизирующего)
-            return (depth % 2 ? 0 : INF);
+            // то у него нет ходов - это проигрыш бота, иначе выигрыш; чем ближе к корню, тем оценка крайнее
+            return (depth % 2 ? -SCORE_WIN + ply : SCORE_WIN - ply);
+        }
+
+        // Выборочный поиск O2: отсечение бесперспективных узлов до перебора ходов
+        if (selective)
+        {
+            int score;
+            if (selective_cut(mtx, color, depth, ply, alpha, beta, remaining, reduced, have_beats, score))
+                return score;
+            if (remaining >= 3)
+                order_turns(color, turns_now);
         }
 
         // Инициализируем минимальную и максимальную оценки
-        double min_score = INF + 1; // Для минимизирующего игрока (четная глубина)
-        double max_score = -1;      // Для максимизирующего игрока (нечетная глубина)
+        int min_score = SCORE_INF;  // Для минимизирующего игрока (четная глубина)
+        int max_score = -SCORE_INF; // Для максимизирующего игрока (нечетная глубина)
 
         // Перебираем все возможные ходы
-        for (auto turn : turns_now)
+        STATS_ONLY(bool is_first_turn = true;)
+        int turn_num = 0;
+        for (const chain_move& turn : turns_now)
         {
-            double score = 0.0;
+            int score = 0;
+            STATS_ONLY(stats.max_chain = max(stats.max_chain, int(turn.count)); stats.chain_nodes += (turn.count > 1);)
+            if (dump)
+                dump->set_move(turn.from, turn.to, turn.count, nodes);
 
-            if (!have_beats_now && x == -1)
+            // Ход (вся серия взятий) делает текущий игрок, затем ход переходит к противнику
+            const board_t next = rules::make_move(mtx, turn);
+            if (repeats_line(mtx, color, ply, turn, next))
             {
-                // Обычный ход (без серии ударов): рекурсивно оцениваем следующее состояние
-                // Ход делает текущий игрок, затем ход переходит к противнику
-                score = find_best_turns_rec(make_turn(mtx, turn), 1 - color, depth + 1, alpha, beta);
+                // Повторение позиции - ничья, дальше не смотрим
+                score = SCORE_DRAW;
+                pv_len[ply + 1] = ply + 1;
+            }
+            else if (selective && !have_beats && remaining >= lmr_min_depth && turn_num >= lmr_full_moves &&
+                TABLES.row[turn.to] % 7 != 0)
+            {
+                // Поздние ходы (после упорядочивания - худшие) сначала смотрим на два хода мельче
+                // (четное сокращение сохраняет, чей ход в листьях); если ход неожиданно улучшает
+                // оценку, пересчитываем его на полную глубину
+                score = find_best_turns_rec(next, !color, depth + 1, ply + 1, alpha, beta, reduced + 2);
+                if (depth % 2 ? score > alpha : score < beta)
+                    score = find_best_turns_rec(next, !color, depth + 1, ply + 1, alpha, beta, reduced);
             }
             else
             {
-                // Продолжение серии ударов: та же шашка должна бить дальше
-                // Ход остается у текущего игрока (глубина не увеличивается)
-                score = find_best_turns_rec(make_turn(mtx, turn), color, depth, alpha, beta, turn.x2, turn.y2);
+                score = find_best_turns_rec(next, !color, depth + 1, ply + 1, alpha, beta, reduced);
             }
+            ++turn_num;
+
+            // Запоминаем главную линию, если ход улучшил оценку текущего игрока
+            if ((depth % 2 ? score > max_score : score < min_score) || pv_len[ply] == ply)
+                update_pv(ply, turn);
 
             // Обновляем минимальную и максимальную оценки
             min_score = min(min_score, score);
@@ -264,11 +821,18 @@ private:
 
             // Если достигнуто условие для отсечения (альфа >= бета),
             // дальнейший поиск в этой ветке не улучшит результат
-            if (optimization != "O0" && alpha >= beta)
+            if (pruning && alpha >= beta)
             {
+                // Ход, давший отсечение, в других позициях этой глубины будет смотреться раньше
+                if (selective && !have_beats)
+                    history[color][turn.from][turn.to] += uint32_t(remaining * remaining);
+                STATS_ONLY(++stats.beta_cutoffs; stats.first_move_cutoffs += is_first_turn;)
+                if (dump)
+                    dump->set_cut(tree_cut::CUTOFF, turn_num - 1);
                 // Возвращаем оценку с небольшим смещением, чтобы сохранить порядок ходов
                 return (depth % 2 ? max_score + 1 : min_score - 1);
             }
+            STATS_ONLY(is_first_turn = false;)
         }
 
         // Возвращаем оценку в зависимости от того, чей сейчас ход
@@ -277,168 +841,343 @@ private:
         return (depth % 2 ? max_score : min_score);
     }
 
-public:
-    // === Пункт 16: Комментарии к перегруженным функциям find_turns ===
-
-    // Находит все возможные ходы для указанного цвета на текущей доске
-    // color: цвет игрока, для которого ищем ходы (false - белые, true - черные)
-    void find_turns(const bool color)
+    // Отсечения выборочного поиска O2 (futility и ProbCut); при отсечении записывает оценку в score
+    // maximizing - ходит бот (нечетная глубина), его оценка должна подняться выше alpha
+    bool selective_cut(const board_t& mtx, const bool color, const size_t depth, const int ply, const int alpha,
+        const int beta, const int remaining, const int reduced, const bool have_beats, int& score)
     {
-        find_turns(color, board->get_board());
-    }
+        const bool maximizing = depth % 2;
 
-    // Находит все возможные ходы для указанной шашки на текущей доске
-    // x, y: координаты шашки
-    void find_turns(const POS_T x, const POS_T y)
-    {
-        find_turns(x, y, board->get_board());
-    }
+        // Futility: у горизонта тихий ход почти не меняет оценку - если даже с запасом
+        // она не дотягивает до границы, перебор ходов ничего не даст
+        if (remaining <= 2 && !have_beats)
+        {
+            const int eval = calc_score(mtx, maximizing == color, ply);
+            const int margin = futility_margin * remaining;
+            if (maximizing ? eval + margin <= alpha : eval - margin >= beta)
+            {
+                if (dump)
+                    dump->set_cut(tree_cut::FUTILITY);
+                score = eval;
+                return true;
+            }
+        }
 
-private:
-    // Находит все возможные ходы для указанного цвета на переданной матрице доски
-    // Результат сохраняется в членах класса turns и have_beats
-    void find_turns(const bool color, const vector<vector<POS_T>>& mtx)
-    {
-        vector<move_pos> res_turns;
-        bool have_beats_before = false;
-        for (POS_T i = 0; i < 8; ++i)
+        // ProbCut: неглубокий поиск с нулевым окном за границей с запасом; если он
+        // уверенно выходит за границу, полный поиск почти наверняка тоже выйдет
+        // Границы выигрыша и проигрыша точны, запас к ним не применяется
+        const int limit = maximizing ? beta : alpha;
+        if (remaining >= probcut_depth && !is_win_score(limit) && !is_loss_score(limit))
         {
-            for (POS_T j = 0; j < 8; ++j)
+            const int bound = maximizing ? beta + probcut_margin : alpha - probcut_margin;
+            if (dump)
+                dump->set_probe(nodes);
+            score = maximizing
+                ? find_best_turns_rec(mtx, color, depth, ply, bound - 1, bound, reduced + probcut_reduction)
+                : find_best_turns_rec(mtx, color, depth, ply, bound, bound + 1, reduced + probcut_reduction);
+            if (maximizing ? score >= bound : score <= bound)
             {
-                if (mtx[i][j] && mtx[i][j] % 2 != color)
-                {
-                    find_turns(i, j, mtx);
-                    if (have_beats && !have_beats_before)
-                    {
-                        have_beats_before = true;
-                        res_turns.clear();
-                    }
-                    if ((have_beats_before && have_beats) || !have_beats_before)
-                    {
-                        res_turns.insert(res_turns.end(), turns.begin(), turns.end());
-                    }
-                }
+                if (dump)
+                    dump->set_cut(tree_cut::PROBCUT);
+                return true;
             }
         }
-        turns = res_turns;
-        shuffle(turns.begin(), turns.end(), rand_eng);
-        have_beats = have_beats_before;
+        return false;
     }
 
-    // Находит все возможные ходы для указанной шашки на переданной матрице доски
-    // x, y: координаты шашки
-    // mtx: матрица доски для анализа
-    void find_turns(const POS_T x, const POS_T y, const vector<vector<POS_T>>& mtx)
+    // Находит удары шашки на переданной доске, а если их нет - ее простые ходы (по одному удару:
+    // побитая шашка сразу снимается). Используется только для проверки, есть ли взятие (has_beats);
+    // ходы для игры дает генератор полных ходов Rules
+    // cell: номер клетки шашки
+    // mtx: доска для анализа
+    static void find_piece_turns(const POS_T cell, const board_t& mtx, move_list& res)
     {
-        turns.clear();
-        have_beats = false;
-        POS_T type = mtx[x][y];
+        res.clear();
+        const POS_T type = mtx[cell];
+        const bool color = piece_color(type);
 
         // Сначала проверяем возможные взятия (бои)
-        switch (type)
+        if (type <= 2)
         {
-        case 1:  // Белая шашка
-        case 2:  // Черная шашка
-            // Проверка взятий для обычных шашек
-            for (POS_T i = x - 2; i <= x + 2; i += 4)
+            // Взятия для обычных шашек (в любую сторону): соседняя клетка - противник, следующая пуста
+            for (POS_T k = 0; k < TABLES.jump_len[cell]; ++k)
             {
-                for (POS_T j = y - 2; j <= y + 2; j += 4)
-                {
-                    if (i < 0 || i > 7 || j < 0 || j > 7)
-                        continue;
-                    POS_T xb = (x + i) / 2, yb = (y + j) / 2;
-                    // Условия для взятия: конечная клетка пуста, между ними шашка противника
-                    if (mtx[i][j] || !mtx[xb][yb] || mtx[xb][yb] % 2 == type % 2)
-                        continue;
-                    turns.emplace_back(x, y, i, j, xb, yb);
-                }
+                const POS_T over = TABLES.jump_over[cell][k], to = TABLES.jump_to[cell][k];
+                if (mtx[to] || !mtx[over] || piece_color(mtx[over]) == color)
+                    continue;
+                res.push_back(packed_move(cell, to, over));
             }
-            break;
-        default:  // Дамки (3 - белая, 4 - черная)
-            // Проверка взятий для дамок
-            for (POS_T i = -1; i <= 1; i += 2)
+        }
+        else
+        {
+            // Взятия для дамок (3 - белая, 4 - черная): дамка может бить через несколько клеток
+            for (int dir = 0; dir < 4; ++dir)
             {
-                for (POS_T j = -1; j <= 1; j += 2)
+                const POS_T* ray = TABLES.ray[cell][dir];
+                POS_T beaten = -1;
+                for (POS_T k = 0; k < TABLES.ray_len[cell][dir]; ++k)
                 {
-                    POS_T xb = -1, yb = -1;
-                    // Дамка может бить через несколько клеток
-                    for (POS_T i2 = x + i, j2 = y + j; i2 != 8 && j2 != 8 && i2 != -1 && j2 != -1; i2 += i, j2 += j)
+                    const POS_T target = mtx[ray[k]];
+                    if (target)
+                    {
+                        // Если встретили свою шашку или вторую шашку противника - прерываем
+                        if (piece_color(target) == color || beaten != -1)
+                            break;
+                        beaten = ray[k];
+                    }
+                    else if (beaten != -1)
                     {
-                        if (mtx[i2][j2])
-                        {
-                            // Если встретили свою шашку или вторую шашку противника - прерываем
-                            if (mtx[i2][j2] % 2 == type % 2 || (mtx[i2][j2] % 2 != type % 2 && xb != -1))
-                            {
-                                break;
-                            }
-                            xb = i2;
-                            yb = j2;
-                        }
-                        if (xb != -1 && xb != i2)
-                        {
-                            turns.emplace_back(x, y, i2, j2, xb, yb);
-                        }
+                        res.push_back(packed_move(cell, ray[k], beaten));
                     }
                 }
             }
-            break;
         }
 
         // Если найдены взятия, возвращаем только их (по правилам шашек, если есть бой - нужно бить)
-        if (!turns.empty())
+        if (!res.empty())
         {
-            have_beats = true;
+            res.have_beats = true;
             return;
         }
 
         // Если взятий нет, ищем обычные ходы
-        switch (type)
+        if (type <= 2)
         {
-        case 1:  // Белая шашка (ходит вверх)
-        case 2:  // Черная шашка (ходит вниз)
-            // Проверка обычных ходов для шашек
+            // Белые шашки ходят вверх, черные - вниз
+            for (POS_T k = 0; k < TABLES.step_len[color][cell]; ++k)
+            {
+                const POS_T to = TABLES.step[color][cell][k];
+                if (!mtx[to])
+                    res.push_back(packed_move(cell, to));
+            }
+        }
+        else
         {
-            POS_T i = ((type % 2) ? x - 1 : x + 1);  // Белые ходят вверх (уменьшение i), черные - вниз
-            for (POS_T j = y - 1; j <= y + 1; j += 2)
+            // Дамки ходят по диагонали до первой занятой клетки
+            for (int dir = 0; dir < 4; ++dir)
             {
-                if (i < 0 || i > 7 || j < 0 || j > 7 || mtx[i][j])
-                    continue;
-                turns.emplace_back(x, y, i, j);
+                const POS_T* ray = TABLES.ray[cell][dir];
+                for (POS_T k = 0; k < TABLES.ray_len[cell][dir] && !mtx[ray[k]]; ++k)
+                    res.push_back(packed_move(cell, ray[k]));
             }
-            break;
         }
-        default:  // Дамки
-            // Проверка обычных ходов для дамок
-            for (POS_T i = -1; i <= 1; i += 2)
+    }
+
+    // Есть ли у игрока color обязательное взятие
+    bool has_beats(const board_t& mtx, const bool color) const
+    {
+        move_list piece_turns;
+        for (POS_T i = 0; i < 32; ++i)
+        {
+            if (mtx[i] && piece_color(mtx[i]) == color)
             {
-                for (POS_T j = -1; j <= 1; j += 2)
-                {
-                    for (POS_T i2 = x + i, j2 = y + j; i2 != 8 && j2 != 8 && i2 != -1 && j2 != -1; i2 += i, j2 += j)
-                    {
-                        if (mtx[i2][j2])
-                            break;
-                        turns.emplace_back(x, y, i2, j2);
-                    }
-                }
+                find_piece_turns(i, mtx, piece_turns);
+                if (piece_turns.have_beats)
+                    return true;
             }
-            break;
+        }
+        return false;
+    }
+
+    // Упорядочивает ходы по истории отсечений (чаще дававшие отсечение - первыми),
+    // чтобы альфа-бета отсекала раньше, а сокращение поздних ходов касалось худших
+    // При равных счетчиках сохраняется перемешанный порядок
+    void order_turns(const bool color, chain_list& turns) const
+    {
+        array<uint32_t, chain_list::CAPACITY> keys;
+        int len = 0;
+        for (const chain_move& turn : turns)
+            keys[len++] = history[color][turn.from][turn.to];
+        chain_move* list = turns.begin();
+        for (int i = 1; i < len; ++i)
+        {
+            const uint32_t key = keys[i];
+            const chain_move turn = list[i];
+            int j = i - 1;
+            for (; j >= 0 && keys[j] < key; --j)
+            {
+                keys[j + 1] = keys[j];
+                list[j + 1] = list[j];
+            }
+            keys[j + 1] = key;
+            list[j + 1] = turn;
         }
     }
 
+public:
+    // === Пункт 16: Комментарии к перегруженным функциям find_turns ===
+
+    // Находит все возможные ходы для указанного цвета на текущей доске
+    // color: цвет игрока, для которого ищем ходы (false - белые, true - черные)
+    void find_turns(const bool color)
+    {
+        move_list res;
+        find_turns(color, to_board(board->get_board()), res);
+        set_turns(res);
+    }
+
+    // Находит продолжения серии ударов игрока color (см. find_series_turns)
+    // mtx: позиция перед ходом, done: уже сделанные удары хода
+    void find_turns(const bool color, const board_t& mtx, const vector<move_pos>& done)
+    {
+        move_list res;
+        find_series_turns(mtx, color, done, res);
+        set_turns(res);
+    }
+
+    // Находит все возможные ходы для указанного цвета на переданной доске (в случайном порядке)
+    // Если хотя бы одна шашка может бить, в результат попадают только взятия
+    void find_turns(const bool color, const board_t& mtx, move_list& res)
+    {
+        generate_turns(color, mtx, res);
+        shuffle(res.begin(), res.end(), rand_eng);
+    }
+
+    // Находит все полные ходы (серии взятий целиком, без повторов) для указанного цвета в случайном порядке
+    void find_chains(const bool color, const board_t& mtx, chain_list& res)
+    {
+        rules::generate(mtx, color, res);
+        shuffle(res.begin(), res.end(), rand_eng);
+    }
+
+    // Раскладывает полный ход на отдельные удары, как их делает игрок (Board::move_piece)
+    static vector<move_pos> to_move_pos_list(const chain_move& turn)
+    {
+        vector<move_pos> res;
+        if (turn.count == 0)
+        {
+            res.emplace_back(dark_cell_x(turn.from), dark_cell_y(turn.from), dark_cell_x(turn.to), dark_cell_y(turn.to));
+            return res;
+        }
+        POS_T pos = turn.from;
+        for (int i = 0; i < turn.count; ++i)
+        {
+            res.emplace_back(dark_cell_x(pos), dark_cell_y(pos), dark_cell_x(turn.path[i]), dark_cell_y(turn.path[i]),
+                dark_cell_x(turn.beaten[i]), dark_cell_y(turn.beaten[i]));
+            pos = turn.path[i];
+        }
+        return res;
+    }
+
+    // Находит ходы как find_turns, но без перемешивания: по порядку полных ходов Rules (не зависит от
+    // состояния Logic, безопасно для потоков)
+    static void generate_turns(const bool color, const board_t& mtx, move_list& res)
+    {
+        find_series_turns(mtx, color, {}, res);
+    }
+
+    // Ходы человека: человек делает полный ход по одному удару, поэтому его ходы - шаги полных ходов Rules
+    // Находит следующие удары серии игрока color, начатой в позиции mtx ударами done (пустой done - начало
+    // хода: первые удары или простые ходы). Побитые шашки, как и в поиске, снимаются после серии, поэтому
+    // человек и клиент сервера ходят по тем же правилам, что и бот. Пустой результат при непустом done -
+    // серия окончена
+    static void find_series_turns(const board_t& mtx, const bool color, const vector<move_pos>& done, move_list& res)
+    {
+        res.clear();
+        chain_list chains;
+        rules::generate(mtx, color, chains);
+        res.have_beats = !chains.empty() && chains.items[0].count > 0;
+        for (const chain_move& chain : chains)
+        {
+            if (size_t(max<int>(chain.count, 1)) <= done.size())
+                continue;
+            bool is_prefix = true;
+            for (size_t i = 0; i < done.size() && is_prefix; ++i)
+                is_prefix = (packed_move(done[i]) == chain_step(chain, int(i)));
+            const packed_move next = chain_step(chain, int(done.size()));
+            if (is_prefix && find(res.begin(), res.end(), next) == res.end())
+                res.push_back(next);
+        }
+    }
+
+    // Шаг i полного хода: удар номер i серии или сам простой ход
+    static packed_move chain_step(const chain_move& turn, const int i)
+    {
+        if (turn.count == 0)
+            return packed_move(turn.from, turn.to);
+        return packed_move(i == 0 ? turn.from : turn.path[i - 1], turn.path[i], turn.beaten[i]);
+    }
+
+private:
+    // Переносит найденные ходы в открытые поля turns и have_beats
+    void set_turns(const move_list& res)
+    {
+        turns.clear();
+        for (const packed_move turn : res)
+            turns.push_back(turn.to_move_pos());
+        have_beats = res.have_beats;
+    }
+
 public:
     // === Пункт 18: Комментарии к полям класса ===
 
     vector<move_pos> turns;  // Список найденных возможных ходов
     bool have_beats;         // Флаг, указывающий, есть ли среди ходов взятия (бои)
     int Max_depth;           // Максимальная глубина поиска для алгоритма минимакс
+    uint64_t nodes = 0;      // Количество узлов последнего поиска (считается всегда, используется бенчмарком)
+    search_stats stats;      // Статистика последнего поиска (заполняется при SEARCH_STATS)
 
 private:
+    static const int MAX_PLY = 64;   // Максимальная длина линии поиска (серия взятий - один ход)
+
     // Приватные поля класса:
     default_random_engine rand_eng;  // Генератор случайных чисел для перемешивания ходов
     string scoring_mode;             // Режим оценки позиции ("NumberAndPotential" или другой)
     string optimization;             // Уровень оптимизации алгоритма ("O0", "O1", и т.д.)
-    vector<move_pos> next_move;      // Вспомогательный массив для хранения лучших ходов в алгоритме минимакс
-    vector<int> next_best_state;     // Вспомогательный массив для связи состояний в алгоритме минимакс
+    bool potential_scoring;          // Учитывать ли продвижение шашек в оценке (scoring_mode)
+    bool pruning;                    // Включено ли альфа-бета отсечение (optimization)
+    bool selective = false;          // Выборочный поиск O2
+    // История отсечений O2: [цвет][откуда][куда] - насколько часто тихий ход давал отсечение
+    array<array<array<uint32_t, 32>, 32>, 2> history{};
+    // Параметры O2 (раздел "O2" в settings.json)
+    int lmr_min_depth = 3;           // С какой оставшейся глубины сокращаются поздние ходы
+    int lmr_full_moves = 3;          // Сколько первых ходов всегда смотрится на полную глубину
+    int futility_margin = 50;        // Запас futility на каждый оставшийся ход (сотые доли шашки)
+    int probcut_depth = 5;           // С какой оставшейся глубины работает ProbCut
+    int probcut_reduction = 4;       // На сколько ходов мельче проверочный поиск ProbCut
+    int probcut_margin = 50;         // Запас ProbCut (сотые доли шашки)
+    // Треугольная таблица главных линий: строка ply хранит лучшую линию узла на этой глубине
+    // Таблица велика для стека потока, поэтому выделяется один раз вместе с Logic
+    typedef array<array<chain_move, MAX_PLY>, MAX_PLY> pv_table;
+    unique_ptr<pv_table> pv = make_unique<pv_table>();
+    array<int, MAX_PLY + 1> pv_len{};
+    // Лучшие линии многолинейного поиска (find_ranked_turns); выделяются при первом вызове
+    static const int MAX_RANKED_TURNS = 16;
+    struct ranked_line
+    {
+        chain_move turn;
+        int score;
+        int pv_len;                        // Длина главной линии после хода
+        array<chain_move, MAX_PLY> pv;
+    };
+    typedef array<ranked_line, MAX_RANKED_TURNS> ranked_table;
+    unique_ptr<ranked_table> ranked;
+    // Списки ходов узлов текущей линии (move_frame); deque не перемещает занятые списки при росте
+    deque<chain_list> move_stack = deque<chain_list>(MAX_PLY);
+    int frames = 0;                  // Занято списков
+    // Ограничения поиска (set_limits)
+    const atomic<bool>* cancel = nullptr;
+    chrono::steady_clock::time_point deadline;
+    bool has_limits = false;
+    bool stopped = false;
+    // Постоянный кэш результатов
+    Analysis_cache* cache = nullptr;
+    unique_ptr<Mcts<Logic>> mcts;    // Поиск Монте-Карло (Engine: "MCTS"), иначе nullptr
+    unique_ptr<Tree_dump> dump;      // Дамп дерева поиска (TreeDump/File), иначе nullptr
+    bool dump_entered = false;       // dump_node уже открыл запись для следующего вызова find_best_turns_rec
+    unique_ptr<Flight_recorder> recorder;  // Журнал последних поисков (FlightRecorder/Searches), иначе nullptr
+    string slow_search_file;         // Файл воспроизведения последнего медленного поиска
+    Search_monitor* monitor = nullptr;  // Панель поиска (set_monitor), иначе nullptr
+    search_snapshot progress;        // Последний опубликованный снимок поиска
+    // Повторения позиций: хеши серии обратимых ходов партии, затем хеши узлов текущей линии поиска
+    vector<uint64_t> game_history;   // Серия обратимых ходов партии перед корнем (set_game_history)
+    vector<uint64_t> rep_hash;       // game_history, затем хеш узла каждой глубины линии
+    size_t rep_base = 0;             // Индекс корня в rep_hash
+    array<int, MAX_PLY + 1> line_run{};     // Обратимых ходов подряд перед узлом глубины ply
+    array<bool, MAX_PLY + 1> hash_known{};  // Посчитан ли хеш узла глубины ply
+    int cache_min_depth = 0;
+    int cache_mode = 0;
+    uint64_t cache_params = 0;       // Ключ параметров O2 (для других режимов 0)
     Board* board;                    // Указатель на объект доски
     Config* config;                  // Указатель на объект конфигурации
-};
\ No newline at end of file
+};
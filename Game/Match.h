@@ -0,0 +1,172 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "Alloc_stats.h"
+#include "Bench.h"
+#include "Board.h"
+#include "Config.h"
+#include "Draw_rule.h"
+#include "Logic.h"
+
+// Структура match_engine - один из участников матча: уровень оптимизации и уровень бота
+// Оптимизация "MCTS" означает поиск Монте-Карло (Engine: "MCTS") с оптимизацией по умолчанию
+struct match_engine
+{
+    string optimization;
+    int level;
+};
+
+// Структура match_timing - суммарное время и количество ходов участников
+struct match_timing
+{
+    double ms_a = 0, ms_b = 0;
+    long long turns_a = 0, turns_b = 0;
+};
+
+// Класс Match - режим "match": партии бот против бота для сравнения силы двух настроек поиска
+// Партии идут парами: одно и то же случайное начало (первые ходы) играется обоими цветами,
+// поэтому преимущество начала у участников одинаковое. Случайность и кэш выключены
+class Match
+{
+public:
+    Match(const match_engine& a, const match_engine& b, const int games, const bool alloc = false)
+        : a(a), b(b), games(games), alloc(alloc)
+    {
+    }
+
+    int run()
+    {
+        if (alloc)
+            Alloc_stats::enable();
+        Config config_a = engine_config(a), config_b = engine_config(b);
+        Board board_a, board_b;
+        Logic logic_a(&board_a, &config_a), logic_b(&board_b, &config_b);
+        logic_a.Max_depth = a.level;
+        logic_b.Max_depth = b.level;
+        const int max_turns = config_a("Game", "MaxNumTurns");
+        const Draw_rule draw_rule(config_a);
+
+        int wins = 0, draws = 0, losses = 0;
+        match_timing timing;
+        for (int game = 0; game < games; ++game)
+        {
+            // В четных партиях A играет белыми
+            const int result = play_game(logic_a, logic_b, game % 2, game / 2, max_turns, draw_rule, timing);
+            wins += result == 2;
+            draws += result == 1;
+            losses += result == 0;
+        }
+
+        const double score = (wins + draws / 2.0) / max(games, 1);
+        cout << "A: " << a.optimization << " level " << a.level << ", B: " << b.optimization << " level " << b.level
+             << "\n";
+        cout << "A wins/draws/losses: " << wins << " / " << draws << " / " << losses << "\n";
+        cout << "A score            : " << score * 100 << "%, Elo " << elo(score) << "\n";
+        cout << "A ms/move          : " << timing.ms_a / max(timing.turns_a, 1LL) << "\n";
+        cout << "B ms/move          : " << timing.ms_b / max(timing.turns_b, 1LL) << endl;
+        if (alloc)
+        {
+            // Все выделения поиска обоих участников, в среднем на партию и на ход
+            const alloc_counters search = Alloc_stats::snapshot(alloc_subsystem::SEARCH);
+            const long long moves = max(timing.turns_a + timing.turns_b, 1LL);
+            cout << "Allocs/game        : " << search.allocations / max(games, 1) << "\n";
+            cout << "Bytes/game         : " << search.bytes / max(games, 1) << "\n";
+            cout << "Allocs/move        : " << double(search.allocations) / moves << "\n";
+            cout << "Bytes/move         : " << double(search.bytes) / moves << "\n";
+            Bench::print_alloc_breakdown(max(logic_a.memory_footprint(), logic_b.memory_footprint()));
+        }
+        return 0;
+    }
+
+    // Разница в рейтинге Эло по доле набранных очков
+    static double elo(const double score)
+    {
+        const double s = min(max(score, 1e-3), 1 - 1e-3);
+        return -400 * log10(1 / s - 1);
+    }
+
+    // Играет одну партию A против B из начала номер opening_seed; a_color - цвет A
+    // Ничья наступает после max_turns ходов или по правилу draw_rule (пустая копия на партию)
+    // Возвращает очки A в полуочках: 2 - победа, 1 - ничья, 0 - поражение; время ходов добавляет в timing
+    static int play_game(Logic& logic_a, Logic& logic_b, const bool a_color, const int opening_seed,
+        const int max_turns, Draw_rule draw_rule, match_timing& timing)
+    {
+        board_t mtx = opening(opening_seed);
+        draw_rule.clear();
+        int result = -1;  // 0 - победа белых, 1 - победа черных, 2 - ничья
+        for (int turn_num = OPENING_TURNS; turn_num < max_turns && result == -1; ++turn_num)
+        {
+            const bool color = turn_num % 2;
+            move_list turns;
+            logic_a.find_turns(color, mtx, turns);
+            if (turns.empty())
+            {
+                result = !color;
+                break;
+            }
+            if (draw_rule.add(mtx, color) != draw_reason::NONE)
+                break;
+            const bool is_a = (color == a_color);
+            (is_a ? logic_a : logic_b).set_game_history(draw_rule.search_history());
+            auto start = chrono::steady_clock::now();
+            const vector<move_pos> best = (is_a ? logic_a : logic_b).find_best_turns(mtx, color);
+            const double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            (is_a ? timing.ms_a : timing.ms_b) += ms;
+            ++(is_a ? timing.turns_a : timing.turns_b);
+            for (const auto& turn : best)
+                mtx = Logic::make_turn(mtx, packed_move(turn));
+        }
+        if (result == -1 || result == 2)
+            return 1;
+        return bool(result) == a_color ? 2 : 0;
+    }
+
+    // Настройки участника: случайность, кэш и журнал поисков выключены
+    static Config engine_config(const match_engine& engine)
+    {
+        Config config;
+        config.set("Bot", "NoRandom", true);
+        config.set("Cache", "File", "");
+        config.set("FlightRecorder", "Searches", 0);
+        if (engine.optimization == "MCTS")
+        {
+            config.set("Bot", "Engine", "MCTS");
+        }
+        else
+        {
+            config.set("Bot", "Engine", "Minimax");
+            config.set("Bot", "Optimization", engine.optimization);
+        }
+        return config;
+    }
+
+private:
+    static constexpr int OPENING_TURNS = 4;  // Случайных ходов в начале партии
+
+    // Случайное начало партии: OPENING_TURNS ходов, одинаковых для пары партий с номером seed
+    static board_t opening(const int seed)
+    {
+        mt19937 rand_eng(seed);
+        board_t mtx = Logic::to_board(Bench::parse_position("bbbbbbbbbbbb........wwwwwwwwwwww"));
+        for (int turn_num = 0; turn_num < OPENING_TURNS; ++turn_num)
+        {
+            // Полные ходы Rules идут в постоянном порядке - начало зависит только от seed
+            Logic::chain_list chains;
+            Logic::rules::generate(mtx, turn_num % 2, chains);
+            if (chains.empty())
+                break;
+            mtx = Logic::rules::make_move(mtx, chains.items[rand_eng() % chains.size]);
+        }
+        return mtx;
+    }
+
+    match_engine a;
+    match_engine b;
+    int games;
+    bool alloc;  // Режим учета выделений памяти
+};
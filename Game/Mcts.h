@@ -0,0 +1,328 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../Models/Mcts_node.h"
+#include "../Models/Move.h"
+#include "../Models/Tables.h"
+
+using namespace std;
+
+// Структура mcts_params - настройки поиска Монте-Карло (раздел "MCTS" в settings.json)
+struct mcts_params
+{
+    size_t playouts_per_level = 3000;  // Симуляций на уровень бота
+    int move_time_ms = 0;              // Ограничение времени на ход (0 - только по числу симуляций)
+    unsigned threads = 1;              // Потоков поиска по общему дереву
+    double exploration = 1.0;          // Коэффициент исследования UCT
+    int rollout_moves = 60;            // Ходов в случайной партии до оценки по материалу
+    size_t arena_nodes = 1 << 20;      // Вместимость массива узлов
+    uint64_t seed = 0;                 // Начальное значение генераторов случайных чисел
+};
+
+// Класс Mcts - поиск Монте-Карло по дереву (UCT) для бота, альтернатива минимаксу
+// Rules - класс с правилами игры: полные ходы rules::generate, chain_list, to_move_pos_list (используется Logic)
+// Каждая симуляция спускается по дереву по формуле UCT, раскрывает лист при повторном посещении
+// и доигрывает партию случайными ходами. Потоки работают с одним деревом: посещение засчитывается
+// при спуске (виртуальный проигрыш), поэтому параллельные потоки расходятся по разным веткам,
+// а очки добавляются после симуляции. Узлы выделяются из заранее созданного массива без блокировок
+template <class Rules> class Mcts
+{
+public:
+    explicit Mcts(const mcts_params& params)
+        : params(params), nodes(new mcts_node[max(params.arena_nodes, size_t(chain_list::CAPACITY) + 1)]),
+          capacity(max(params.arena_nodes, size_t(chain_list::CAPACITY) + 1))
+    {
+    }
+
+    // Находит лучший полный ход color из позиции mtx (серия ударов - несколько move_pos)
+    // level: уровень бота (число симуляций - playouts_per_level * level)
+    // cancel и deadline - внешние ограничения (cancel может отсутствовать)
+    vector<move_pos> search(const board_t& mtx, const bool color, const int level, const atomic<bool>* cancel,
+        const chrono::steady_clock::time_point deadline)
+    {
+        chain_list root_turns;
+        Rules::rules::generate(mtx, color, root_turns);
+        if (root_turns.empty())
+            return {};
+        root = mtx;
+        root_color = color;
+        playouts_limit = max(params.playouts_per_level * size_t(max(level, 1)), size_t(1));
+        this->cancel = cancel;
+        this->deadline = deadline;
+        stop_time = deadline;
+        if (params.move_time_ms > 0)
+            stop_time = min(stop_time, chrono::steady_clock::now() + chrono::milliseconds(params.move_time_ms));
+        started = 0;
+        finished = 0;
+        stopped = false;
+        is_over = false;
+
+        // Корень раскрывается сразу
+        nodes[0].reset(0, !color);
+        nodes[0].first_child = 1;
+        nodes[0].child_count = uint8_t(root_turns.size);
+        for (size_t i = 0; i < root_turns.size; ++i)
+            nodes[1 + i].reset(pack(root_turns.items[i]), color);
+        nodes[0].state.store(mcts_node::EXPANDED, memory_order_release);
+        used = 1 + root_turns.size;
+
+        const unsigned threads_num = max(params.threads, 1u);
+        vector<thread> threads;
+        for (unsigned i = 1; i < threads_num; ++i)
+            threads.emplace_back(&Mcts::work, this, i);
+        work(0);
+        for (auto& th : threads)
+            th.join();
+        return best_turns();
+    }
+
+    // Количество симуляций последнего поиска
+    uint64_t playouts() const
+    {
+        return finished.load();
+    }
+
+    // Количество узлов дерева последнего поиска
+    size_t tree_size() const
+    {
+        return min(used.load(), capacity);
+    }
+
+    // Размер массива узлов в байтах (выделяется один раз в конструкторе)
+    size_t memory() const
+    {
+        return capacity * sizeof(mcts_node);
+    }
+
+    // Был ли последний поиск прерван отменой или внешним крайним сроком
+    bool is_stopped() const
+    {
+        return stopped;
+    }
+
+private:
+    typedef typename Rules::chain_list chain_list;
+    typedef typename Rules::chain_move chain_move;
+
+    static constexpr int MAX_PATH = 256;  // Максимальная длина пути от корня (с запасом)
+
+    // Упаковывает полный ход в 64 бита: маска побитых шашек (биты 0-31), начальная клетка (32-36),
+    // конечная (37-41), превращение в дамку (42). Этого достаточно, чтобы сделать ход (apply)
+    static uint64_t pack(const chain_move& turn)
+    {
+        return (turn.captured & 0xFFFFFFFFull) | (uint64_t(turn.from) << 32) | (uint64_t(turn.to) << 37) |
+            (uint64_t(turn.promotes) << 42);
+    }
+
+    // Делает упакованный ход: побитые шашки снимаются после серии, как в Rules
+    static board_t apply(board_t mtx, const uint64_t turn)
+    {
+        const POS_T from = POS_T((turn >> 32) & 31), to = POS_T((turn >> 37) & 31);
+        POS_T type = mtx[from];
+        mtx[from] = 0;
+        for (POS_T i = 0; i < 32; ++i)
+        {
+            if ((turn >> i) & 1)
+                mtx[i] = 0;
+        }
+        if ((turn >> 42) & 1)
+            type += 2;
+        mtx[to] = type;
+        return mtx;
+    }
+
+    // Генератор случайных чисел xorshift64*: быстрый и свой у каждого потока
+    struct xorshift
+    {
+        uint64_t state;
+
+        explicit xorshift(const uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ull + 0x2545F4914F6CDD1Dull)
+        {
+        }
+
+        uint32_t operator()(const uint32_t n)
+        {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return uint32_t(((state * 0x2545F4914F6CDD1Dull) >> 32) % n);
+        }
+    };
+
+    // Исход симуляции
+    static constexpr int WHITE_WIN = 0, BLACK_WIN = 1, DRAW = 2;
+
+    void work(const unsigned thread_index)
+    {
+        xorshift rand(params.seed + thread_index);
+        while (!is_over.load(memory_order_relaxed))
+        {
+            const uint64_t n = started.fetch_add(1, memory_order_relaxed);
+            if (n >= playouts_limit || ((n & 63) == 0 && n > 0 && limits_reached()))
+            {
+                is_over = true;
+                break;
+            }
+            playout(rand);
+            finished.fetch_add(1, memory_order_relaxed);
+        }
+    }
+
+    // Проверяет отмену и время (после первой симуляции результат уже есть)
+    bool limits_reached()
+    {
+        const bool cancelled = cancel && cancel->load(memory_order_relaxed);
+        const auto now = chrono::steady_clock::now();
+        if (cancelled || now >= deadline)
+            stopped = true;
+        return cancelled || now >= stop_time;
+    }
+
+    // Одна симуляция: спуск по дереву, раскрытие листа, случайная партия и обновление очков на пути
+    void playout(xorshift& rand)
+    {
+        uint32_t path[MAX_PATH];
+        int len = 0;
+        board_t mtx = root;
+        bool color = root_color;  // Кто ходит в текущем узле
+        uint32_t index = 0;
+        uint32_t prev_visits = nodes[0].visits.fetch_add(1, memory_order_relaxed);
+        path[len++] = 0;
+        int result;
+        while (true)
+        {
+            mcts_node& node = nodes[index];
+            uint8_t state = node.state.load(memory_order_acquire);
+            if (state == mcts_node::LEAF && prev_visits > 0 && expand(node, mtx, color))
+                state = mcts_node::EXPANDED;
+            if (state != mcts_node::EXPANDED || len == MAX_PATH)
+            {
+                result = rollout(mtx, color, rand);
+                break;
+            }
+            if (node.child_count == 0)
+            {
+                result = color ? WHITE_WIN : BLACK_WIN;  // Ходящему нечем ходить - он проиграл
+                break;
+            }
+            index = select(node);
+            mcts_node& child = nodes[index];
+            prev_visits = child.visits.fetch_add(1, memory_order_relaxed);  // Виртуальный проигрыш до конца симуляции
+            path[len++] = index;
+            mtx = apply(mtx, child.turn);
+            color = !color;
+        }
+
+        for (int i = 0; i < len; ++i)
+        {
+            mcts_node& node = nodes[path[i]];
+            node.score.fetch_add(result == DRAW ? 1 : (result == node.mover ? 2 : 0), memory_order_relaxed);
+        }
+    }
+
+    // Раскрывает лист: создает детей для всех ходов; false, если узел раскрывает другой поток или нет места
+    bool expand(mcts_node& node, const board_t& mtx, const bool color)
+    {
+        chain_list turns;
+        Rules::rules::generate(mtx, color, turns);
+        if (used.load(memory_order_relaxed) + turns.size > capacity)
+            return false;
+
+        uint8_t expected = mcts_node::LEAF;
+        if (!node.state.compare_exchange_strong(expected, mcts_node::EXPANDING, memory_order_acquire))
+            return false;
+        const size_t first = used.fetch_add(turns.size, memory_order_relaxed);
+        if (first + turns.size > capacity)
+        {
+            node.state.store(mcts_node::LEAF, memory_order_release);
+            return false;
+        }
+        for (size_t i = 0; i < turns.size; ++i)
+            nodes[first + i].reset(pack(turns.items[i]), color);
+        node.first_child = uint32_t(first);
+        node.child_count = uint8_t(turns.size);
+        node.state.store(mcts_node::EXPANDED, memory_order_release);
+        return true;
+    }
+
+    // Выбор ребенка по UCT: средний результат плюс надбавка за редко посещаемые ходы
+    uint32_t select(const mcts_node& node) const
+    {
+        const double log_visits = log(double(max(node.visits.load(memory_order_relaxed), 1u)));
+        uint32_t best = node.first_child;
+        double best_value = -1;
+        for (uint32_t i = node.first_child; i < node.first_child + node.child_count; ++i)
+        {
+            const uint32_t visits = nodes[i].visits.load(memory_order_relaxed);
+            if (visits == 0)
+                return i;
+            const double value = nodes[i].score.load(memory_order_relaxed) / (2.0 * visits) +
+                params.exploration * sqrt(log_visits / visits);
+            if (value > best_value)
+            {
+                best_value = value;
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    // Случайная партия по правилам (взятия обязательны); если она не закончилась за rollout_moves ходов,
+    // побеждает сторона с большим материалом (дамка - три шашки)
+    int rollout(board_t mtx, bool color, xorshift& rand) const
+    {
+        chain_list turns;
+        for (int i = 0; i < params.rollout_moves; ++i)
+        {
+            Rules::rules::generate(mtx, color, turns);
+            if (turns.empty())
+                return color ? WHITE_WIN : BLACK_WIN;
+            mtx = Rules::rules::make_move(mtx, turns.items[rand(uint32_t(turns.size))]);
+            color = !color;
+        }
+        int balance = 0;  // Белые минус черные
+        for (const POS_T type : mtx)
+            balance += (type == 1) - (type == 2) + 3 * ((type == 3) - (type == 4));
+        return balance > 0 ? WHITE_WIN : (balance < 0 ? BLACK_WIN : DRAW);
+    }
+
+    // Ход бота: самый посещаемый ход корня, разложенный на отдельные удары
+    vector<move_pos> best_turns() const
+    {
+        const mcts_node& node = nodes[0];
+        const mcts_node* best = &nodes[node.first_child];
+        for (uint32_t i = node.first_child; i < node.first_child + node.child_count; ++i)
+        {
+            if (nodes[i].visits.load() > best->visits.load())
+                best = &nodes[i];
+        }
+        chain_list turns;
+        Rules::rules::generate(root, root_color, turns);
+        for (const chain_move& turn : turns)
+        {
+            if (pack(turn) == best->turn)
+                return Rules::to_move_pos_list(turn);
+        }
+        return {};
+    }
+
+    mcts_params params;
+    unique_ptr<mcts_node[]> nodes;  // Массив узлов; узел 0 - корень
+    const size_t capacity;
+    atomic<size_t> used{ 0 };       // Занятых узлов
+    board_t root;
+    bool root_color = false;
+    size_t playouts_limit = 0;
+    const atomic<bool>* cancel = nullptr;
+    chrono::steady_clock::time_point deadline;   // Внешний крайний срок (сервер)
+    chrono::steady_clock::time_point stop_time;  // С учетом ограничения времени на ход
+    atomic<uint64_t> started{ 0 };
+    atomic<uint64_t> finished{ 0 };
+    atomic<bool> stopped{ false };
+    atomic<bool> is_over{ false };
+};
@@ -0,0 +1,234 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Board.h"
+#include "Logic.h"
+
+// Структура render_job - одно изображение: диаграмма позиции или лист партии (несколько позиций сеткой)
+struct render_job
+{
+    string path;                 // Файл PNG
+    vector<board_t> positions;   // Позиции; больше одной - лист партии
+};
+
+// Класс Offscreen_renderer рисует позиции без окна в поверхности SDL (SDL_Surface) и сохраняет их в PNG
+// Используются те же текстуры и та же разметка клеток, что и в Board::rerender. Окно и видеоподсистема
+// SDL не создаются, поэтому X-сервер не нужен. Рисование и сжатие PNG выполняет пул потоков;
+// у каждого потока свои текстуры, заранее масштабированные под размер изображения
+class Offscreen_renderer
+{
+public:
+    // size: размер диаграммы в пикселях, thumb_size: размер позиции на листе партии,
+    // columns: позиций в строке листа, workers: количество потоков (0 - по числу ядер)
+    Offscreen_renderer(const int size, const int thumb_size, const int columns, size_t workers)
+        : size(size), thumb_size(thumb_size), columns(columns)
+    {
+        IMG_Init(IMG_INIT_PNG);
+        if (workers == 0)
+            workers = max(1u, thread::hardware_concurrency());
+        for (size_t i = 0; i < workers; ++i)
+            threads.emplace_back(&Offscreen_renderer::work, this);
+    }
+
+    // Ставит изображение в очередь; ждет, если очередь заполнена (память под задания ограничена)
+    void submit(render_job&& job)
+    {
+        unique_lock<mutex> lock(jobs_mutex);
+        space_cv.wait(lock, [this] { return jobs.size() < MAX_QUEUE; });
+        jobs.push_back(move(job));
+        jobs_cv.notify_one();
+    }
+
+    // Дожидается отрисовки всех изображений и останавливает потоки
+    void finish()
+    {
+        {
+            lock_guard<mutex> lock(jobs_mutex);
+            if (is_finished)
+                return;
+            is_finished = true;
+        }
+        jobs_cv.notify_all();
+        for (auto& th : threads)
+            th.join();
+        IMG_Quit();
+    }
+
+    // Количество сохраненных и неудавшихся изображений
+    size_t saved() const
+    {
+        return saved_num.load();
+    }
+    size_t failed() const
+    {
+        return failed_num.load();
+    }
+
+    ~Offscreen_renderer()
+    {
+        finish();
+    }
+
+private:
+    // Текстуры одного потока, масштабированные под размер позиции
+    struct Textures
+    {
+        int size = 0;
+        SDL_Surface* board = nullptr;
+        SDL_Surface* pieces[5] = {};  // Индекс - тип фигуры (1-4)
+
+        void clear()
+        {
+            SDL_FreeSurface(board);
+            for (auto& piece : pieces)
+                SDL_FreeSurface(piece);
+            *this = Textures();
+        }
+    };
+
+    // Исходные изображения текстур потока (SDL_BlitScaled меняет служебные поля исходной поверхности,
+    // поэтому потоки не делят поверхности между собой)
+    struct Sources
+    {
+        SDL_Surface* board = nullptr;
+        SDL_Surface* pieces[5] = {};
+
+        ~Sources()
+        {
+            SDL_FreeSurface(board);
+            for (auto& piece : pieces)
+                SDL_FreeSurface(piece);
+        }
+    };
+
+    static constexpr size_t MAX_QUEUE = 1024;
+
+    // Загружает исходные текстуры из тех же файлов, что и Board
+    static bool load(Sources& sources)
+    {
+        const Board paths;
+        sources.board = IMG_Load(paths.board_path.c_str());
+        sources.pieces[1] = IMG_Load(paths.piece_white_path.c_str());
+        sources.pieces[2] = IMG_Load(paths.piece_black_path.c_str());
+        sources.pieces[3] = IMG_Load(paths.queen_white_path.c_str());
+        sources.pieces[4] = IMG_Load(paths.queen_black_path.c_str());
+        return sources.board && sources.pieces[1] && sources.pieces[2] && sources.pieces[3] && sources.pieces[4];
+    }
+
+    // Масштабирует поверхность в новую поверхность w x h с сохранением прозрачности
+    static SDL_Surface* scaled(SDL_Surface* src, const int w, const int h)
+    {
+        SDL_Surface* res = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!res)
+            return nullptr;
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);  // Копируем и альфа-канал
+        SDL_BlitScaled(src, nullptr, res, nullptr);
+        SDL_SetSurfaceBlendMode(res, SDL_BLENDMODE_BLEND);
+        return res;
+    }
+
+    // Готовит текстуры для позиции размером pos_size (при том же размере повторно не масштабирует)
+    static bool prepare(Textures& textures, Sources& sources, const int pos_size)
+    {
+        if (textures.size == pos_size)
+            return true;
+        textures.clear();
+        textures.size = pos_size;
+        textures.board = scaled(sources.board, pos_size, pos_size);
+        const SDL_Rect rect = Board::piece_rect(pos_size, pos_size, 0, 0);
+        for (int type = 1; type < 5; ++type)
+            textures.pieces[type] = scaled(sources.pieces[type], rect.w, rect.h);
+        SDL_SetSurfaceBlendMode(textures.board, SDL_BLENDMODE_NONE);
+        return textures.board && textures.pieces[1] && textures.pieces[2] && textures.pieces[3] && textures.pieces[4];
+    }
+
+    // Рисует позицию mtx в квадрат со стороной textures.size с левым верхним углом (x0, y0)
+    static void draw(const board_t& mtx, const Textures& textures, SDL_Surface* dst, const int x0, const int y0)
+    {
+        SDL_Rect board_rect{ x0, y0, textures.size, textures.size };
+        SDL_BlitSurface(textures.board, nullptr, dst, &board_rect);
+        for (POS_T cell = 0; cell < 32; ++cell)
+        {
+            if (!mtx[cell])
+                continue;
+            SDL_Rect rect = Board::piece_rect(textures.size, textures.size, dark_cell_x(cell), dark_cell_y(cell));
+            rect.x += x0;
+            rect.y += y0;
+            SDL_BlitSurface(textures.pieces[mtx[cell]], nullptr, dst, &rect);
+        }
+    }
+
+    // Рисует и сохраняет одно изображение
+    bool render(const render_job& job, Textures& textures, Sources& sources) const
+    {
+        alloc_scope scope(alloc_subsystem::RENDERING);
+        const bool is_sheet = job.positions.size() > 1;
+        const int pos_size = is_sheet ? thumb_size : size;
+        if (job.positions.empty() || !prepare(textures, sources, pos_size))
+            return false;
+        const int cols = is_sheet ? min(columns, int(job.positions.size())) : 1;
+        const int rows = (int(job.positions.size()) + cols - 1) / cols;
+
+        SDL_Surface* image = SDL_CreateRGBSurfaceWithFormat(0, cols * pos_size, rows * pos_size, 32,
+            SDL_PIXELFORMAT_ARGB8888);
+        if (!image)
+            return false;
+        for (size_t i = 0; i < job.positions.size(); ++i)
+            draw(job.positions[i], textures, image, int(i % cols) * pos_size, int(i / cols) * pos_size);
+        const bool ok = IMG_SavePNG(image, job.path.c_str()) == 0;
+        SDL_FreeSurface(image);
+        return ok;
+    }
+
+    void work()
+    {
+        Sources sources;
+        const bool loaded = load(sources);
+        if (!loaded)
+            Logger::get().error("IMG_Load can't load textures for offscreen rendering", { { "sdl_error", SDL_GetError() } });
+        Textures textures;
+        while (true)
+        {
+            render_job job;
+            {
+                unique_lock<mutex> lock(jobs_mutex);
+                jobs_cv.wait(lock, [this] { return is_finished || !jobs.empty(); });
+                if (jobs.empty())
+                    break;
+                job = move(jobs.front());
+                jobs.pop_front();
+            }
+            space_cv.notify_one();
+
+            trace_span span("render_png", "render", "positions", job.positions.size());
+            if (loaded && render(job, textures, sources))
+            {
+                ++saved_num;
+            }
+            else
+            {
+                ++failed_num;
+                Logger::get().error("Can't render image", { { "file", job.path.c_str() }, { "sdl_error", SDL_GetError() } });
+            }
+        }
+        textures.clear();
+    }
+
+    const int size;
+    const int thumb_size;
+    const int columns;
+    mutex jobs_mutex;
+    condition_variable jobs_cv;   // Есть задания или пора завершаться
+    condition_variable space_cv;  // В очереди освободилось место
+    deque<render_job> jobs;
+    bool is_finished = false;
+    atomic<size_t> saved_num{ 0 };
+    atomic<size_t> failed_num{ 0 };
+    vector<thread> threads;
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "Rules.h"
+
+// Класс Perft - режим "perft": подсчет позиций дерева ходов из начальной расстановки для варианта правил
+// Серия взятий - один ход, одинаковые серии разными путями считаются один раз. Числа для каждой глубины
+// можно сравнить с опубликованными значениями perft, поэтому режим проверяет генератор ходов варианта
+class Perft
+{
+public:
+    Perft(const string& variant, const int depth) : variant(variant), depth(depth)
+    {
+    }
+
+    int run()
+    {
+        if (variant == russian_variant::NAME)
+            return run_variant<russian_variant>();
+        if (variant == english_variant::NAME)
+            return run_variant<english_variant>();
+        if (variant == international_variant::NAME)
+            return run_variant<international_variant>();
+        cerr << "Unknown variant " << variant << " (russian, english, international)" << endl;
+        return 1;
+    }
+
+    // Количество позиций на глубине depth (ходы по очереди, начиная с color)
+    template <class Variant> static uint64_t count(const typename Rules<Variant>::board& mtx, const bool color, const int depth)
+    {
+        typename Rules<Variant>::move_list turns;
+        Rules<Variant>::generate(mtx, color, turns);
+        if (depth <= 1)
+            return depth == 1 ? turns.size : 1;
+        uint64_t res = 0;
+        for (const auto& turn : turns)
+            res += count<Variant>(Rules<Variant>::make_move(mtx, turn), !color, depth - 1);
+        return res;
+    }
+
+private:
+    template <class Variant> int run_variant() const
+    {
+        const auto start_mtx = Rules<Variant>::start_position();
+        auto start = chrono::steady_clock::now();
+        for (int d = 1; d <= depth; ++d)
+        {
+            const uint64_t nodes = count<Variant>(start_mtx, false, d);
+            const double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            cout << Variant::NAME << " perft " << d << ": " << nodes << " (" << (long long)ms << " ms)" << endl;
+        }
+        return 0;
+    }
+
+    string variant;
+    int depth;
+};
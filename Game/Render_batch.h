@@ -0,0 +1,154 @@
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "Config.h"
+#include "Logic.h"
+#include "Offscreen_renderer.h"
+
+// Класс Render_batch - режим "render": пакетная отрисовка позиций и партий в PNG без окна
+// Входной файл - по одной записи в строке:
+//   позиция: 32 символа по игровым клеткам ('.', 'w', 'b', 'W', 'B'), как в бенчмарке -> pos_<N>.png
+//   партия: ходы от начальной расстановки через пробел ("5243 2534 ...", серия ударов - отдельными ходами)
+//     -> game_<N>_<ход>.png для каждого хода или один лист game_<N>.png в режиме sheet
+// N - номер строки входного файла; пустые строки и строки с '#' пропускаются
+class Render_batch
+{
+public:
+    Render_batch(const string& input, const string& out_dir, const bool sheet)
+        : input(input), out_dir(out_dir), sheet(sheet)
+    {
+    }
+
+    int run()
+    {
+        ifstream fin(input);
+        if (!fin)
+        {
+            cerr << "Can't open " << input << endl;
+            return 1;
+        }
+        filesystem::create_directories(out_dir);
+
+        auto start = chrono::steady_clock::now();
+        size_t games = 0, positions = 0, skipped = 0;
+        Offscreen_renderer renderer(config("Render", "Size"), config("Render", "ThumbSize"),
+            config("Render", "Columns"), size_t(int(config("Render", "Workers"))));
+        string line;
+        for (int line_num = 1; getline(fin, line); ++line_num)
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            if (is_position(line))
+            {
+                renderer.submit({ file_name("pos_", line_num, -1), { Logic::to_board(Bench::parse_position(line)) } });
+                ++positions;
+                continue;
+            }
+
+            vector<board_t> game;
+            if (!parse_game(line, game))
+            {
+                Logger::get().warning("Render: illegal move in game", { { "line", line_num } });
+                ++skipped;
+                continue;
+            }
+            ++games;
+            if (sheet)
+            {
+                renderer.submit({ file_name("game_", line_num, -1), move(game) });
+                continue;
+            }
+            for (size_t ply = 0; ply < game.size(); ++ply)
+                renderer.submit({ file_name("game_", line_num, int(ply)), { game[ply] } });
+        }
+        renderer.finish();
+
+        const double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "Positions       : " << positions << "\n";
+        cout << "Games           : " << games << " (skipped " << skipped << ")\n";
+        cout << "Images saved    : " << renderer.saved() << " (failed " << renderer.failed() << ")\n";
+        cout << "Images/minute   : " << (long long)(renderer.saved() * 60 / max(sec, 1e-3)) << endl;
+        return renderer.failed() ? 1 : 0;
+    }
+
+private:
+    static bool is_position(const string& line)
+    {
+        return line.size() == 32 && line.find_first_not_of(".wbWB") == string::npos;
+    }
+
+    // Имя файла: <out_dir>/<prefix><N>[_<ply>].png
+    string file_name(const char* prefix, const int line_num, const int ply) const
+    {
+        ostringstream name;
+        name << prefix << line_num;
+        if (ply != -1)
+            name << "_" << setw(3) << setfill('0') << ply;
+        name << ".png";
+        return (filesystem::path(out_dir) / name.str()).string();
+    }
+
+    // Разыгрывает партию с проверкой ходов (как в Game::play); game - позиции до и после каждого хода
+    bool parse_game(const string& line, vector<board_t>& game)
+    {
+        board_t mtx = Logic::to_board(Bench::parse_position("bbbbbbbbbbbb........wwwwwwwwwwww"));
+        game.assign(1, mtx);
+        bool color = false;
+        board_t start = mtx;     // Позиция перед текущим ходом
+        vector<move_pos> done;   // Уже сделанные удары текущей серии
+        istringstream in(line);
+        string token;
+        while (in >> token)
+        {
+            if (token.size() != 4)
+                return false;
+            const move_pos wanted(POS_T(token[0] - '0'), POS_T(token[1] - '0'), POS_T(token[2] - '0'),
+                POS_T(token[3] - '0'));
+            move_list turns;
+            if (done.empty())
+                start = mtx;
+            Logic::find_series_turns(start, color, done, turns);
+            const packed_move* found = nullptr;
+            for (const packed_move& turn : turns)
+            {
+                if (turn.to_move_pos() == wanted)
+                    found = &turn;
+            }
+            if (!found)
+                return false;
+            mtx = Logic::make_turn(mtx, *found);
+            game.push_back(mtx);
+
+            // Серия ударов продолжается, пока сделанные удары - начало более длинного полного хода,
+            // иначе ход переходит к сопернику
+            move_list next;
+            if (found->is_beat())
+            {
+                done.push_back(found->to_move_pos());
+                Logic::find_series_turns(start, color, done, next);
+            }
+            if (next.empty())
+            {
+                done.clear();
+                color = !color;
+            }
+        }
+        return true;
+    }
+
+    string input;
+    string out_dir;
+    bool sheet;
+    Config config;
+};
@@ -0,0 +1,311 @@
+#pragma once
+#include <array>
+
+#include "../Models/Compound_move.h"
+#include "../Models/Tables.h"
+#include "../Models/Variant.h"
+
+using namespace std;
+
+// Класс Rules - генератор полных ходов для варианта правил Variant (см. Models/Variant.h)
+// Правила варианта - константы шаблона, поэтому ветви "if constexpr" для других правил в код не попадают
+// Серия взятий генерируется целиком как один ход (compound_move) по "турецкому" правилу: побитые шашки
+// остаются на доске до конца хода, и перепрыгнуть их второй раз нельзя. Одинаковые ходы, отличающиеся
+// только путем, выдаются один раз
+// Коды фигур - как в Logic: 1 - белая шашка, 2 - черная, 3 - белая дамка, 4 - черная; белые ходят вверх
+template <class Variant> class Rules
+{
+public:
+    static constexpr int SIZE = Variant::SIZE;
+    static constexpr int CELLS = SIZE * SIZE / 2;
+    static constexpr int MAX_CAPTURES = (SIZE / 2 - 1) * SIZE / 2;  // Все шашки соперника
+    static constexpr size_t MAX_MOVES = SIZE == 8 ? 128 : 256;      // С запасом для позиций с дамками
+
+    typedef array<POS_T, CELLS> board;
+    typedef compound_move<CELLS, MAX_CAPTURES> move;
+    typedef fixed_list<move, MAX_MOVES> move_list;
+
+    // Начальная расстановка: черные сверху, белые снизу, по MEN_ROWS строк
+    static board start_position()
+    {
+        board res{};
+        for (int cell = 0; cell < CELLS; ++cell)
+        {
+            const int row = T.row[cell];
+            if (row < Variant::MEN_ROWS)
+                res[cell] = 2;
+            else if (row >= SIZE - Variant::MEN_ROWS)
+                res[cell] = 1;
+        }
+        return res;
+    }
+
+    // Все ходы игрока color (false - белые, true - черные)
+    // Если есть взятие, в результат попадают только взятия (при MAJORITY_CAPTURE - только самые длинные)
+    static void generate(const board& mtx, const bool color, move_list& res)
+    {
+        res.clear();
+        for (int cell = 0; cell < CELLS; ++cell)
+        {
+            if (mtx[cell] && piece_color(mtx[cell]) == color)
+                find_captures(mtx, POS_T(cell), res);
+        }
+        if (!res.empty())
+        {
+            if constexpr (Variant::MAJORITY_CAPTURE)
+                keep_longest(res);
+            return;
+        }
+        for (int cell = 0; cell < CELLS; ++cell)
+        {
+            if (mtx[cell] && piece_color(mtx[cell]) == color)
+                find_quiet(mtx, POS_T(cell), res);
+        }
+    }
+
+    // Выполняет ход и возвращает новую позицию
+    static board make_move(board mtx, const move& turn)
+    {
+        POS_T type = mtx[turn.from];
+        mtx[turn.from] = 0;
+        for (int i = 0; i < turn.count; ++i)
+            mtx[turn.beaten[i]] = 0;
+        if (turn.promotes)
+            type += 2;
+        mtx[turn.to] = type;
+        return mtx;
+    }
+
+    // Клетка по координатам и координаты клетки
+    static constexpr POS_T cell(const int x, const int y)
+    {
+        return board_tables<SIZE>::cell(x, y);
+    }
+    static constexpr POS_T cell_x(const int c)
+    {
+        return board_tables<SIZE>::cell_x(c);
+    }
+    static constexpr POS_T cell_y(const int c)
+    {
+        return board_tables<SIZE>::cell_y(c);
+    }
+
+private:
+    static constexpr const board_tables<SIZE>& T = BOARD_TABLES<SIZE>;
+
+    // Строка превращения для цвета: белые - верхняя, черные - нижняя
+    static constexpr int promotion_row(const bool color)
+    {
+        return color ? SIZE - 1 : 0;
+    }
+
+    // Направление ведет вперед для цвета (белые - вверх: 0 и 1, черные - вниз: 2 и 3)
+    static constexpr bool is_forward(const int dir, const bool color)
+    {
+        return (dir / 2) == int(color);
+    }
+
+    static bool is_enemy(const POS_T type, const bool color)
+    {
+        return type && piece_color(type) != color;
+    }
+
+    // Состояние серии взятий одной шашкой
+    struct chain
+    {
+        const board& mtx;
+        move current;   // Уже сделанная часть серии
+        bool color;
+        move_list& res;
+    };
+
+    // Добавляет все серии взятий шашкой с клетки from
+    static void find_captures(const board& mtx, const POS_T from, move_list& res)
+    {
+        chain state{ mtx, move(), piece_color(mtx[from]), res };
+        state.current.from = from;
+        extend(state, from, mtx[from] > 2);
+    }
+
+    // Клетка свободна для шашки, делающей ход (ее начальная клетка уже освободилась)
+    static bool is_free(const chain& state, const POS_T target)
+    {
+        return !state.mtx[target] || target == state.current.from;
+    }
+
+    // Продолжает серию с клетки pos; если продолжить нельзя, записывает ход
+    static void extend(chain& state, const POS_T pos, const bool is_king)
+    {
+        bool extended = false;
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            if constexpr (!Variant::MEN_CAPTURE_BACK)
+            {
+                if (!is_king && !is_forward(dir, state.color))
+                    continue;
+            }
+            const POS_T* ray = T.ray[pos][dir];
+            const int len = T.ray_len[pos][dir];
+            int k = 0;
+            if (Variant::FLYING_KINGS && is_king)
+            {
+                while (k < len && is_free(state, ray[k]))
+                    ++k;
+            }
+            // ray[k] - первая фигура на диагонали: бить можно только непобитую шашку соперника
+            if (k + 1 >= len || !is_enemy(state.mtx[ray[k]], state.color) || (state.current.captured >> ray[k]) & 1)
+                continue;
+            const POS_T over = ray[k];
+
+            // Клетки приземления: сразу за шашкой, у дамки - любая свободная дальше по диагонали
+            int last = k + 1;
+            if (Variant::FLYING_KINGS && is_king)
+            {
+                while (last + 1 < len && is_free(state, ray[last + 1]))
+                    ++last;
+            }
+            if (!is_free(state, ray[k + 1]))
+                continue;
+
+            // Дамка обязана приземлиться там, откуда можно бить дальше, если такая клетка есть
+            bool need_continue = false;
+            if (Variant::FLYING_KINGS && is_king && last > k + 1)
+            {
+                for (int i = k + 1; i <= last && !need_continue; ++i)
+                    need_continue = can_capture(state, ray[i], over, dir);
+            }
+            for (int i = k + 1; i <= last; ++i)
+            {
+                if (need_continue && !can_capture(state, ray[i], over, dir))
+                    continue;
+                capture(state, over, ray[i], is_king);
+                extended = true;
+            }
+        }
+        if (!extended && state.current.count > 0)
+            record(state, pos, is_king);
+    }
+
+    // Делает одно взятие шашки over с приземлением на to и продолжает серию
+    static void capture(chain& state, const POS_T over, const POS_T to, const bool is_king)
+    {
+        move& cur = state.current;
+        const move saved = cur;
+        cur.beaten[cur.count] = over;
+        cur.path[cur.count] = to;
+        ++cur.count;
+        cur.captured |= uint64_t(1) << over;
+
+        bool next_king = is_king;
+        if (!is_king && T.row[to] == promotion_row(state.color))
+        {
+            if constexpr (Variant::PROMOTION == promotion_rule::ENDS_CAPTURE)
+            {
+                cur.to = to;
+                cur.promotes = true;
+                add(state.res, cur);
+                cur = saved;
+                return;
+            }
+            if constexpr (Variant::PROMOTION == promotion_rule::DURING_CAPTURE)
+            {
+                next_king = true;
+                cur.promotes = true;
+            }
+        }
+        extend(state, to, next_king);
+        cur = saved;
+    }
+
+    // Может ли фигура на клетке pos бить после взятия шашки over в направлении dir
+    // (назад по той же диагонали бить нельзя - там только что побитая шашка)
+    static bool can_capture(chain& state, const POS_T pos, const POS_T over, const int dir)
+    {
+        const uint64_t captured = state.current.captured | (uint64_t(1) << over);
+        for (int d = 0; d < 4; ++d)
+        {
+            if (d == 3 - dir)
+                continue;
+            const POS_T* ray = T.ray[pos][d];
+            const int len = T.ray_len[pos][d];
+            int k = 0;
+            while (k < len && is_free(state, ray[k]))
+                ++k;
+            if (k + 1 < len && is_enemy(state.mtx[ray[k]], state.color) && !((captured >> ray[k]) & 1) &&
+                is_free(state, ray[k + 1]))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Записывает законченную серию, закончившуюся на клетке pos
+    static void record(chain& state, const POS_T pos, const bool is_king)
+    {
+        move turn = state.current;
+        turn.to = pos;
+        if constexpr (Variant::PROMOTION == promotion_rule::AFTER_CAPTURE)
+            turn.promotes = !is_king && T.row[pos] == promotion_row(state.color);
+        add(state.res, turn);
+    }
+
+    // Добавляет ход, если такого же (с тем же набором побитых шашек) еще нет
+    static void add(move_list& res, const move& turn)
+    {
+        for (const move& other : res)
+        {
+            if (other.same_as(turn))
+                return;
+        }
+        if (res.size < move_list::CAPACITY)
+            res.push_back(turn);
+    }
+
+    // Оставляет только взятия наибольшего числа шашек
+    static void keep_longest(move_list& res)
+    {
+        uint8_t longest = 0;
+        for (const move& turn : res)
+            longest = max(longest, turn.count);
+        size_t size = 0;
+        for (const move& turn : res)
+        {
+            if (turn.count == longest)
+                res.items[size++] = turn;
+        }
+        res.size = size;
+    }
+
+    // Добавляет ходы без взятия фигурой с клетки from
+    static void find_quiet(const board& mtx, const POS_T from, move_list& res)
+    {
+        const POS_T type = mtx[from];
+        const bool color = piece_color(type);
+        move turn;
+        turn.from = from;
+        if (type <= 2)
+        {
+            for (int k = 0; k < T.step_len[color][from]; ++k)
+            {
+                const POS_T to = T.step[color][from][k];
+                if (mtx[to])
+                    continue;
+                turn.to = to;
+                turn.promotes = T.row[to] == promotion_row(color);
+                res.push_back(turn);
+            }
+            return;
+        }
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            const POS_T* ray = T.ray[from][dir];
+            const int len = Variant::FLYING_KINGS ? T.ray_len[from][dir] : min<int>(T.ray_len[from][dir], 1);
+            for (int k = 0; k < len && !mtx[ray[k]]; ++k)
+            {
+                turn.to = ray[k];
+                res.push_back(turn);
+            }
+        }
+    }
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+#include "../Models/Search_snapshot.h"
+
+using namespace std;
+
+// Класс Search_monitor - передача состояния поиска из потока поиска в поток отрисовки без блокировок
+// Снимок пишется под счетчиком версий (seqlock): писатель никогда не ждет, читатель повторяет чтение,
+// если снимок менялся во время копирования. Счетчик узлов обновляется отдельно и чаще - одной записью
+class Search_monitor
+{
+public:
+    // Публикует снимок (поток поиска; писатель один)
+    void publish(const search_snapshot& s)
+    {
+        array<uint64_t, WORDS> buf{};
+        memcpy(buf.data(), &s, sizeof(s));
+        const uint32_t seq = sequence.load(memory_order_relaxed);
+        sequence.store(seq + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i)
+            words[i].store(buf[i], memory_order_relaxed);
+        sequence.store(seq + 2, memory_order_release);
+        nodes.store(s.nodes, memory_order_relaxed);
+    }
+
+    // Обновляет только счетчик узлов (поток поиска)
+    void set_nodes(const uint64_t n)
+    {
+        nodes.store(n, memory_order_relaxed);
+    }
+
+    // Читает последний целый снимок и досчитывает время поиска; false - снимка еще нет или писатель
+    // все время был занят (тогда панель показывает прошлый снимок)
+    bool read(search_snapshot& out) const
+    {
+        for (int attempt = 0; attempt < 16; ++attempt)
+        {
+            const uint32_t before = sequence.load(memory_order_acquire);
+            if (before == 0 || (before & 1))
+                continue;
+            array<uint64_t, WORDS> buf;
+            for (size_t i = 0; i < WORDS; ++i)
+                buf[i] = words[i].load(memory_order_relaxed);
+            atomic_thread_fence(memory_order_acquire);
+            if (sequence.load(memory_order_relaxed) != before)
+                continue;
+            memcpy(static_cast<void*>(&out), buf.data(), sizeof(out));
+            if (out.running)
+            {
+                out.nodes = max(out.nodes, nodes.load(memory_order_relaxed));
+                const auto now = chrono::steady_clock::now().time_since_epoch().count();
+                out.elapsed_ms = chrono::duration<double, milli>(chrono::steady_clock::duration(now - out.start_ticks)).count();
+            }
+            return true;
+        }
+        return false;
+    }
+
+private:
+    static constexpr size_t WORDS = (sizeof(search_snapshot) + 7) / 8;
+
+    atomic<uint32_t> sequence{ 0 };  // Нечетный - снимок пишется
+    array<atomic<uint64_t>, WORDS> words{};
+    atomic<uint64_t> nodes{ 0 };
+};
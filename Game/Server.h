@@ -0,0 +1,507 @@
+#pragma once
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Config.h"
+#include "Draw_rule.h"
+#include "Engine_pool.h"
+#include "Logger.h"
+#include "Logic.h"
+
+// Протокол сервера: текстовые строки, одна команда на строку
+// Клиент -> сервер:
+//   NEW [level] [white|black]   - новая партия; аргументы в любом порядке, уровень не больше MAX_LEVEL,
+//                                 цвет человека (по умолчанию белые), бот играет другим цветом
+//   MOVE <id> <xyx2y2>          - ход человека, например "MOVE 1 5243"; серия ударов - несколькими MOVE
+//   GO <id>                     - повторить запрос хода бота (после BUSY или TIMEOUT)
+//   CLOSE <id>                  - закрыть партию (поиск хода для нее отменяется)
+// Сервер -> клиент:
+//   GAME <id> <board> <moves>       - партия создана (moves - ходы человека или "-", если первым ходит бот)
+//   CONTINUE <id> <board> <moves>   - серия ударов продолжается, moves - возможные продолжения
+//   BOT <id> <turns> <board> <moves> - ход бота (серия через запятую) и ответные ходы человека
+//   END <id> <white|black|draw>     - партия окончена (ничья - по MaxNumTurns, RepetitionDraw или NoProgressDraw)
+//   BUSY <id> / TIMEOUT <id>        - очередь поиска заполнена / ход бота не успел к сроку
+//   CLOSED <id>, ERROR <id> <reason>
+//   (reason: bad_argument - неверный аргумент NEW, unknown_game, unknown_command, bad_move - ход не из
+//   четырех цифр 0-7, not_your_turn, illegal_move)
+// board - 32 символа по игровым клеткам ('.', 'w', 'b', 'W', 'B'), ход - четыре цифры x y x2 y2
+
+// Структура server_session - состояние одной партии (без потоков; растет только журнал позиций Draw_rule)
+struct server_session
+{
+    int conn;                          // Сокет клиента, владеющего партией
+    board_t mtx;                       // Позиция
+    int turn_num = 0;                  // Номер хода: четный - ходят белые
+    board_t turn_start;                // Позиция перед ходом человека (для проверки серии ударов)
+    vector<move_pos> series;           // Уже сделанные удары текущей серии человека
+    int beat_series = 0;               // Номер удара в текущей серии
+    int level;                         // Уровень бота
+    bool bot_color;                    // Цвет бота
+    bool bot_busy = false;             // Запрос хода бота в очереди или в работе
+    Draw_rule draw_rule{ 0, 0 };       // Ничья по повторению и отсутствию прогресса (как в Game::play)
+    shared_ptr<atomic<bool>> cancel;   // Флаг отмены текущего запроса
+};
+
+// Класс Server - сервер множества партий "человек против бота" на локальном TCP-порту
+// Ввод-вывод обслуживает один поток (poll), ходы бота считает общий пул Engine_pool
+class Server
+{
+public:
+    Server() : validator(&validator_board, &config)
+    {
+        port = config("Server", "Port");
+        max_turns = config("Game", "MaxNumTurns");
+        default_level = config("Server", "BotLevel");
+        deadline_ms = config("Server", "DeadlineMS");
+    }
+
+    // Запускает сервер; возвращает код завершения программы
+    int run()
+    {
+        listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        int yes = 1;
+        setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(uint16_t(port));
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);  // Только локальные подключения
+        if (listen_fd < 0 || ::bind(listen_fd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd, 128) != 0)
+        {
+            Logger::get().error("Server can't listen", { { "port", port } });
+            cerr << "Can't listen on 127.0.0.1:" << port << endl;
+            return 1;
+        }
+        set_nonblocking(listen_fd);
+
+        // Канал пробуждения: потоки поиска сообщают о готовых ходах
+        int wake[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, wake) != 0)
+            return 1;
+        wake_read = wake[0];
+        wake_write = wake[1];
+        set_nonblocking(wake_read);
+        set_nonblocking(wake_write);
+
+        Engine_pool pool(config, size_t(int(config("Server", "Workers"))), size_t(int(config("Server", "QueueSize"))),
+            [this](engine_result&& result) {
+                {
+                    lock_guard<mutex> lock(results_mutex);
+                    results.push_back(move(result));
+                }
+                char c = 1;
+                (void)!write(wake_write, &c, 1);
+            });
+        engines = &pool;
+
+        Logger::get().info("Server started", { { "port", port } });
+        cout << "Listening on 127.0.0.1:" << port << endl;
+        vector<pollfd> fds;
+        while (true)
+        {
+            fds.clear();
+            fds.push_back({ listen_fd, POLLIN, 0 });
+            fds.push_back({ wake_read, POLLIN, 0 });
+            for (const auto& conn : connections)
+                fds.push_back({ conn.first, short(POLLIN | (conn.second.out.empty() ? 0 : POLLOUT)), 0 });
+            if (poll(fds.data(), fds.size(), -1) < 0)
+                continue;
+
+            if (fds[0].revents & POLLIN)
+                accept_connections();
+            if (fds[1].revents & POLLIN)
+                process_results();
+            for (size_t i = 2; i < fds.size(); ++i)
+            {
+                if (fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+                    read_connection(fds[i].fd);
+                if ((fds[i].revents & POLLOUT) && connections.count(fds[i].fd))
+                    flush_connection(fds[i].fd);
+            }
+        }
+    }
+
+private:
+    // Буферы одного подключения
+    struct Connection
+    {
+        string in;
+        string out;
+        vector<uint64_t> sessions;  // Партии, созданные этим подключением
+    };
+
+    static void set_nonblocking(const int fd)
+    {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+
+    void accept_connections()
+    {
+        while (true)
+        {
+            const int fd = accept(listen_fd, nullptr, nullptr);
+            if (fd < 0)
+                return;
+            set_nonblocking(fd);
+            int yes = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+            connections[fd];
+        }
+    }
+
+    void read_connection(const int fd)
+    {
+        char buf[4096];
+        while (true)
+        {
+            const ssize_t len = read(fd, buf, sizeof(buf));
+            if (len == 0 || (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+            {
+                close_connection(fd);
+                return;
+            }
+            if (len < 0)
+                break;
+            connections[fd].in.append(buf, size_t(len));
+        }
+
+        // Разбираем все полные строки
+        string& in = connections[fd].in;
+        size_t start = 0, end;
+        while ((end = in.find('\n', start)) != string::npos)
+        {
+            handle_command(fd, in.substr(start, end - start));
+            if (!connections.count(fd))
+                return;
+            start = end + 1;
+        }
+        in.erase(0, start);
+        if (in.empty())
+            in.shrink_to_fit();  // Простаивающее подключение не держит буфер
+    }
+
+    void flush_connection(const int fd)
+    {
+        string& out = connections[fd].out;
+        const ssize_t len = ::send(fd, out.data(), out.size(), MSG_NOSIGNAL);
+        if (len > 0)
+            out.erase(0, size_t(len));
+        if (out.empty())
+            out.shrink_to_fit();
+    }
+
+    void close_connection(const int fd)
+    {
+        for (const uint64_t id : connections[fd].sessions)
+            close_session(id);
+        connections.erase(fd);
+        close(fd);
+    }
+
+    void close_session(const uint64_t id)
+    {
+        auto it = sessions.find(id);
+        if (it == sessions.end())
+            return;
+        it->second.cancel->store(true);
+        sessions.erase(it);
+    }
+
+    // Отправляет строку клиенту (запись в сокет - при готовности)
+    void reply(const int fd, const string& line)
+    {
+        auto it = connections.find(fd);
+        if (it == connections.end())
+            return;
+        it->second.out += line;
+        it->second.out += '\n';
+        flush_connection(fd);
+    }
+
+    void handle_command(const int fd, const string& line)
+    {
+        istringstream in(line);
+        string cmd;
+        in >> cmd;
+        if (cmd == "NEW")
+        {
+            int level = default_level;
+            string human = "white";
+            // Необязательные аргументы различаются по виду: число - уровень, white/black - цвет человека
+            string arg;
+            while (in >> arg)
+            {
+                if (arg == "white" || arg == "black")
+                    human = arg;
+                else if (arg.find_first_not_of("0123456789") == string::npos)
+                    level = arg.size() > 3 ? MAX_LEVEL : stoi(arg);
+                else
+                {
+                    reply(fd, "ERROR 0 bad_argument");
+                    return;
+                }
+            }
+            const uint64_t id = ++last_id;
+            server_session& s = sessions[id];
+            s.conn = fd;
+            s.mtx = Logic::to_board(start_mtx());
+            s.level = min(max(0, level), MAX_LEVEL);
+            s.bot_color = (human != "black");
+            s.cancel = make_shared<atomic<bool>>(false);
+            s.draw_rule = Draw_rule(config);
+            s.draw_rule.add(s.mtx, false);
+            connections[fd].sessions.push_back(id);
+            if (s.bot_color)
+            {
+                reply(fd, "GAME " + to_string(id) + " " + board_str(s.mtx) + " " + moves_str(human_turns(s)));
+            }
+            else
+            {
+                reply(fd, "GAME " + to_string(id) + " " + board_str(s.mtx) + " -");
+                start_bot(id, s);
+            }
+            return;
+        }
+
+        uint64_t id = 0;
+        in >> id;
+        auto it = sessions.find(id);
+        if (it == sessions.end() || it->second.conn != fd)
+        {
+            reply(fd, "ERROR " + to_string(id) + " unknown_game");
+            return;
+        }
+        server_session& s = it->second;
+        if (cmd == "MOVE")
+        {
+            string turn;
+            in >> turn;
+            human_move(id, s, turn);
+        }
+        else if (cmd == "GO")
+        {
+            if (!s.bot_busy && (s.turn_num % 2) == s.bot_color)
+                start_bot(id, s);
+        }
+        else if (cmd == "CLOSE")
+        {
+            close_session(id);
+            reply(fd, "CLOSED " + to_string(id));
+        }
+        else
+        {
+            reply(fd, "ERROR " + to_string(id) + " unknown_command");
+        }
+    }
+
+    // Обрабатывает ход человека по правилам Game::play
+    void human_move(const uint64_t id, server_session& s, const string& turn_str)
+    {
+        if (turn_str.size() != 4 || turn_str.find_first_not_of("01234567") != string::npos)
+        {
+            reply(s.conn, "ERROR " + to_string(id) + " bad_move");
+            return;
+        }
+        if (s.bot_busy || (s.turn_num % 2) == s.bot_color)
+        {
+            reply(s.conn, "ERROR " + to_string(id) + " not_your_turn");
+            return;
+        }
+        move_list turns = human_turns(s);
+        const move_pos wanted(POS_T(turn_str[0] - '0'), POS_T(turn_str[1] - '0'), POS_T(turn_str[2] - '0'),
+            POS_T(turn_str[3] - '0'));
+        const packed_move* found = nullptr;
+        for (const packed_move& turn : turns)
+        {
+            if (turn.to_move_pos() == wanted)
+                found = &turn;
+        }
+        if (!found)
+        {
+            reply(s.conn, "ERROR " + to_string(id) + " illegal_move");
+            return;
+        }
+        if (s.series.empty())
+            s.turn_start = s.mtx;
+        s.mtx = Logic::make_turn(s.mtx, *found);
+
+        // Серия ударов продолжается, пока сделанные удары - начало более длинного полного хода
+        if (found->is_beat())
+        {
+            s.series.push_back(found->to_move_pos());
+            const move_list next = human_turns(s);
+            if (!next.empty())
+            {
+                reply(s.conn, "CONTINUE " + to_string(id) + " " + board_str(s.mtx) + " " + moves_str(next));
+                return;
+            }
+        }
+        s.series.clear();
+        if (finish_turn(id, s))
+            return;
+        start_bot(id, s);
+    }
+
+    // Завершает ход; возвращает true, если партия окончена (результат уже отправлен)
+    bool finish_turn(const uint64_t id, server_session& s)
+    {
+        const string result = next_turn(s);
+        if (result.empty())
+            return false;
+        end_game(id, s, result);
+        return true;
+    }
+
+    // Передает ход сопернику по правилам Game::play; возвращает результат партии ("white", "black",
+    // "draw") или пустую строку, если партия продолжается
+    string next_turn(server_session& s)
+    {
+        ++s.turn_num;
+        const bool color = s.turn_num % 2;
+        move_list turns;
+        Logic::generate_turns(color, s.mtx, turns);
+        if (s.turn_num >= max_turns)
+            return "draw";
+        if (turns.empty())
+            return color ? "white" : "black";  // У ходящего нет ходов - он проиграл
+        s.draw_rule.truncate(size_t(s.turn_num));
+        if (s.draw_rule.add(s.mtx, color) != draw_reason::NONE)
+            return "draw";
+        return "";
+    }
+
+    void end_game(const uint64_t id, server_session& s, const string& result)
+    {
+        reply(s.conn, "END " + to_string(id) + " " + result);
+        close_session(id);
+    }
+
+    // Ставит запрос хода бота в очередь пула
+    void start_bot(const uint64_t id, server_session& s)
+    {
+        engine_job job{ id, s.mtx, s.bot_color, s.level,
+            chrono::steady_clock::now() + chrono::milliseconds(deadline_ms), s.cancel, s.draw_rule.search_history() };
+        if (!engines->submit(move(job)))
+        {
+            reply(s.conn, "BUSY " + to_string(id));
+            return;
+        }
+        s.bot_busy = true;
+    }
+
+    // Применяет готовые ходы бота к партиям
+    void process_results()
+    {
+        char buf[256];
+        while (read(wake_read, buf, sizeof(buf)) > 0)
+        {
+        }
+        vector<engine_result> ready;
+        {
+            lock_guard<mutex> lock(results_mutex);
+            ready.swap(results);
+        }
+        for (auto& result : ready)
+        {
+            auto it = sessions.find(result.session_id);
+            if (it == sessions.end())
+                continue;
+            server_session& s = it->second;
+            s.bot_busy = false;
+            if (result.timeout || result.turns.empty())
+            {
+                reply(s.conn, "TIMEOUT " + to_string(result.session_id));
+                continue;
+            }
+            string turns;
+            for (const auto& turn : result.turns)
+            {
+                s.mtx = Logic::make_turn(s.mtx, packed_move(turn));
+                turns += (turns.empty() ? "" : ",") + turn_str(turn);
+            }
+            const uint64_t id = result.session_id;
+            const string game_result = next_turn(s);
+            reply(s.conn, "BOT " + to_string(id) + " " + turns + " " + board_str(s.mtx) + " " +
+                              (game_result.empty() ? moves_str(human_turns(s)) : string("-")));
+            if (!game_result.empty())
+                end_game(id, s, game_result);
+        }
+    }
+
+    // Ходы человека в текущем состоянии партии (с учетом серии ударов)
+    move_list human_turns(const server_session& s)
+    {
+        move_list res;
+        if (!s.series.empty())
+            Logic::find_series_turns(s.turn_start, !s.bot_color, s.series, res);
+        else
+            validator.find_turns(!s.bot_color, s.mtx, res);
+        return res;
+    }
+
+    // Начальная расстановка шашек (как в Board::make_start_mtx)
+    static vector<vector<POS_T>> start_mtx()
+    {
+        vector<vector<POS_T>> mtx(8, vector<POS_T>(8, 0));
+        for (POS_T i = 0; i < 8; ++i)
+            for (POS_T j = 0; j < 8; ++j)
+                if ((i + j) % 2 == 1)
+                    mtx[i][j] = (i < 3 ? 2 : (i > 4 ? 1 : 0));
+        return mtx;
+    }
+
+    static string board_str(const board_t& mtx)
+    {
+        const char symbols[] = ".wbWB";
+        string res(32, '.');
+        for (POS_T cell = 0; cell < 32; ++cell)
+            res[cell] = symbols[mtx[cell]];
+        return res;
+    }
+
+    static string turn_str(const move_pos& turn)
+    {
+        return { char('0' + turn.x), char('0' + turn.y), char('0' + turn.x2), char('0' + turn.y2) };
+    }
+
+    static string moves_str(const move_list& turns)
+    {
+        string res;
+        for (const packed_move turn : turns)
+            res += (res.empty() ? "" : ",") + turn_str(turn.to_move_pos());
+        return res.empty() ? "-" : res;
+    }
+
+    static constexpr int MAX_LEVEL = 12;  // Наибольший уровень бота в NEW (предел O1)
+
+    Config config;
+    Board validator_board;                       // Не используется для отрисовки
+    Logic validator;                             // Генератор ходов для проверки ходов человека
+    int port;
+    int max_turns;
+    int default_level;
+    int deadline_ms;
+    int listen_fd = -1;
+    int wake_read = -1, wake_write = -1;
+    Engine_pool* engines = nullptr;
+    unordered_map<int, Connection> connections;
+    unordered_map<uint64_t, server_session> sessions;
+    uint64_t last_id = 0;
+    mutex results_mutex;
+    vector<engine_result> results;               // Готовые ходы от потоков поиска
+};
+#endif
@@ -0,0 +1,361 @@
+#pragma once
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "Bench.h"
+#include "Config.h"
+#include "Logic.h"
+
+// Структура solver_entry - запись таблицы решателя (24 байта)
+struct solver_entry
+{
+    uint64_t key = 0;    // Хеш позиции, очереди хода и числа оставшихся ходов (0 - пустая запись)
+    uint32_t phi = 0;    // Число доказательства для ходящего (0 - ходящий добивается цели)
+    uint32_t delta = 0;  // Число опровержения для ходящего (0 - ходящий цели не добивается)
+    uint32_t work = 0;   // Размер просмотренного поддерева (для сборки мусора)
+};
+
+// Класс Solver - режим "solve": точное решение позиции поиском по числам доказательства (df-pn)
+// Отвечает на вопрос "выигрыш, проигрыш или ничья" по правилам игры, включая ничью по MaxNumTurns:
+// первый поиск доказывает выигрыш ходящего, второй - выигрыш соперника; если оба опровергнуты - ничья.
+// Полный ход (вся серия ударов) - один переход, поэтому в узле ходит одна сторона.
+// Число оставшихся ходов входит в ключ позиции, поэтому граф поиска ациклический.
+// Ничьи по повторению и отсутствию прогресса (RepetitionDraw, NoProgressDraw, Draw_rule) не учитываются:
+// результат - решение по правилам без них (об этом печатается строка "Draw rules")
+class Solver
+{
+public:
+    enum class Result
+    {
+        WIN,      // Ходящий выигрывает
+        LOSS,     // Ходящий проигрывает
+        DRAW,     // Ничья при лучшей игре обеих сторон
+        UNKNOWN   // Превышен предел узлов
+    };
+
+    Solver()
+    {
+        max_turns = config("Game", "MaxNumTurns");
+        max_nodes = uint64_t(double(config("Solver", "MaxNodes")));
+        const size_t table_mb = size_t(int(config("Solver", "TableMB")));
+        table.resize(max(table_mb << 20, sizeof(solver_entry) * BUCKET) / sizeof(solver_entry));
+    }
+
+    // Решает позицию и печатает результат
+    // cells: позиция в формате бенчмарка, color: кто ходит, turn_num: номер хода (для MaxNumTurns)
+    int run(const string& cells, const bool color, const int turn_num)
+    {
+        const board_t mtx = Logic::to_board(Bench::parse_position(cells));
+        auto start = chrono::steady_clock::now();
+        const Result result = solve(mtx, color, max_turns - turn_num);
+        const double sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        const char* names[] = { "win", "loss", "draw", "unknown (node limit)" };
+        cout << "Result          : " << names[int(result)] << " for " << (color ? "black" : "white") << "\n";
+        cout << "Draw rules      : MaxNumTurns only (RepetitionDraw and NoProgressDraw are ignored)\n";
+        if (!best_move.empty())
+            cout << "Best move       : " << best_move << "\n";
+        cout << "Proof tree size : " << proof_size << (proof_complete ? "" : " (partly collected)") << "\n";
+        cout << "Nodes searched  : " << nodes << "\n";
+        cout << "Table entries   : " << used << " of " << table.size() << ", collections " << collections << "\n";
+        cout << "Time (s)        : " << sec << endl;
+        return result == Result::UNKNOWN ? 1 : 0;
+    }
+
+    // Решает позицию: turns_left - сколько ходов осталось до ничьей по MaxNumTurns
+    Result solve(const board_t& mtx, const bool color, const int turns_left)
+    {
+        nodes = 0;
+        aborted = false;
+        best_move.clear();
+        proof_size = 0;
+        proof_complete = true;
+
+        // Выигрывает ли ходящий
+        const Result win = prove(mtx, color, turns_left, true);
+        if (win != Result::DRAW)
+            return win == Result::WIN ? Result::WIN : Result::UNKNOWN;
+        const uint64_t win_disproof = proof_size;
+
+        // Выигрывает ли соперник; если нет, лучший ход ходящего - ход, сохраняющий ничью
+        const Result loss = prove(mtx, color, turns_left, false);
+        if (loss == Result::UNKNOWN)
+            return Result::UNKNOWN;
+        proof_size += (loss == Result::DRAW ? win_disproof : 0);
+        return loss == Result::WIN ? Result::LOSS : Result::DRAW;
+    }
+
+private:
+    static constexpr uint32_t INF = 1u << 30;  // Бесконечность для чисел доказательства
+    static constexpr size_t BUCKET = 8;         // Записей, просматриваемых для одного ключа
+
+    // Доказывает, что цели добивается attacker (ходящий, если mover_attacks, иначе соперник)
+    // Возвращает WIN, если доказано, DRAW, если опровергнуто, UNKNOWN при превышении предела
+    Result prove(const board_t& mtx, const bool color, const int turns_left, const bool mover_attacks)
+    {
+        fill(table.begin(), table.end(), solver_entry());
+        used = 0;
+        attacker = mover_attacks ? color : !color;
+        uint32_t phi, delta;
+        mid(mtx, color, turns_left, INF - 1, INF - 1, phi, delta);
+        if (aborted || (phi != 0 && delta != 0))
+            return Result::UNKNOWN;
+
+        // Цель атакующего в корне: ходящий атакует - phi = 0, защищается - delta = 0
+        const bool proven = mover_attacks ? phi == 0 : delta == 0;
+        unordered_set<uint64_t> visited;
+        proof_size = tree_size(mtx, color, turns_left, visited);
+
+        // Лучший ход корня - ход в позицию, где соперник цели не добивается
+        if (phi == 0)
+        {
+            vector<board_t> children;
+            vector<string> moves;
+            expand(mtx, color, children, &moves);
+            for (size_t i = 0; i < children.size(); ++i)
+            {
+                uint32_t child_phi, child_delta;
+                lookup(children[i], !color, turns_left - 1, child_phi, child_delta);
+                if (child_delta == 0)
+                {
+                    best_move = moves[i];
+                    break;
+                }
+            }
+        }
+        return proven ? Result::WIN : Result::DRAW;
+    }
+
+    // Поиск df-pn: расширяет узел, пока его числа не превысят пороги phi_t, delta_t
+    // Возвращает размер просмотренного поддерева
+    uint64_t mid(const board_t& mtx, const bool color, const int turns_left, const uint32_t phi_t,
+        const uint32_t delta_t, uint32_t& phi, uint32_t& delta)
+    {
+        if (lookup(mtx, color, turns_left, phi, delta) && (phi >= phi_t || delta >= delta_t))
+            return 0;
+        if (max_nodes && nodes >= max_nodes)
+        {
+            aborted = true;
+            return 0;
+        }
+        ++nodes;
+
+        vector<board_t> children;
+        expand(mtx, color, children, nullptr);
+        uint64_t work = 1;
+        while (true)
+        {
+            // phi узла - минимум delta детей, delta узла - сумма phi детей
+            uint32_t min_delta = INF, second_delta = INF, best_phi = 0;
+            uint64_t sum_phi = 0;
+            size_t best = 0;
+            for (size_t i = 0; i < children.size(); ++i)
+            {
+                uint32_t child_phi, child_delta;
+                lookup(children[i], !color, turns_left - 1, child_phi, child_delta);
+                sum_phi = (child_phi == INF || sum_phi == INF) ? INF : min<uint64_t>(sum_phi + child_phi, INF - 1);
+                if (child_delta < min_delta)
+                {
+                    second_delta = min_delta;
+                    min_delta = child_delta;
+                    best_phi = child_phi;
+                    best = i;
+                }
+                else if (child_delta < second_delta)
+                {
+                    second_delta = child_delta;
+                }
+            }
+            phi = min_delta;
+            delta = uint32_t(sum_phi);
+            if (phi >= phi_t || delta >= delta_t || aborted)
+                break;
+
+            // Пороги для лучшего ребенка
+            const uint32_t child_phi_t = uint32_t(min<uint64_t>(uint64_t(delta_t) + best_phi - delta, INF - 1));
+            const uint32_t child_delta_t = min(phi_t, second_delta == INF ? INF - 1 : second_delta + 1);
+            uint32_t child_phi, child_delta;
+            work += mid(children[best], !color, turns_left - 1, child_phi_t, child_delta_t, child_phi, child_delta);
+        }
+        store(mtx, color, turns_left, phi, delta, work);
+        return work;
+    }
+
+    // Числа узла: из таблицы, для конечной позиции - точные, иначе начальные (1, 1)
+    // Возвращает true, если узел найден в таблице или конечный
+    bool lookup(const board_t& mtx, const bool color, const int turns_left, uint32_t& phi, uint32_t& delta)
+    {
+        // Ходы закончились - ничья: атакующий цели не добился
+        if (turns_left <= 0)
+        {
+            phi = (color == attacker) ? INF : 0;
+            delta = (color == attacker) ? 0 : INF;
+            return true;
+        }
+        const uint64_t key = node_key(mtx, color, turns_left);
+        const size_t base = size_t(key % table.size()) & ~(BUCKET - 1);
+        for (size_t i = base; i < base + BUCKET && i < table.size(); ++i)
+        {
+            if (table[i].key == key)
+            {
+                phi = table[i].phi;
+                delta = table[i].delta;
+                return true;
+            }
+        }
+        // Нет ходов - ходящий проиграл (цели не добился, кем бы он ни был)
+        Logic::chain_list chains;
+        Logic::rules::generate(mtx, color, chains);
+        if (chains.empty())
+        {
+            phi = INF;
+            delta = 0;
+            return true;
+        }
+        phi = 1;
+        delta = 1;
+        return false;
+    }
+
+    // Сохраняет узел. Если группа записей заполнена: при занятой больше чем наполовину таблице
+    // собирается мусор, иначе вытесняется запись группы с наименьшим поддеревом
+    void store(const board_t& mtx, const bool color, const int turns_left, const uint32_t phi, const uint32_t delta,
+        const uint64_t work)
+    {
+        const uint64_t key = node_key(mtx, color, turns_left);
+        size_t slot = find_slot(key);
+        if (table[slot].key != key && table[slot].key != 0 && used * 2 >= table.size())
+        {
+            collect_garbage();
+            slot = find_slot(key);
+        }
+        used += (table[slot].key == 0);
+        table[slot] = { key, phi, delta, uint32_t(min<uint64_t>(work, UINT32_MAX)) };
+    }
+
+    // Запись для ключа: с тем же ключом, иначе пустая, иначе с наименьшим поддеревом в группе
+    size_t find_slot(const uint64_t key) const
+    {
+        const size_t base = size_t(key % table.size()) & ~(BUCKET - 1);
+        const size_t end = min(base + BUCKET, table.size());
+        size_t slot = base;
+        for (size_t i = base; i < end; ++i)
+        {
+            if (table[i].key == key)
+                return i;
+            if (table[slot].key != 0 && (table[i].key == 0 || table[i].work < table[slot].work))
+                slot = i;
+        }
+        return slot;
+    }
+
+    // Сборка мусора: удаляет примерно половину записей - записи самых маленьких поддеревьев
+    // Маленькие поддеревья дешево пересчитать, а большие хранят основную часть работы
+    void collect_garbage()
+    {
+        ++collections;
+        size_t count_by_log[33] = {};
+        for (const auto& entry : table)
+        {
+            if (entry.key)
+                ++count_by_log[log2_floor(entry.work)];
+        }
+        int threshold = 0;
+        size_t removed = 0;
+        while (threshold < 32 && removed + count_by_log[threshold] <= used / 2)
+            removed += count_by_log[threshold++];
+        if (removed == 0)
+            removed += count_by_log[threshold++];  // Хотя бы одна группа удаляется
+        for (auto& entry : table)
+        {
+            if (entry.key && log2_floor(entry.work) < threshold)
+            {
+                entry = solver_entry();
+                --used;
+            }
+        }
+    }
+
+    static int log2_floor(uint32_t value)
+    {
+        int res = 0;
+        while (value >>= 1)
+            ++res;
+        return res;
+    }
+
+    // Размер дерева доказательства (различные позиции): для успеха ходящего - один ход,
+    // для неудачи - все ходы. Узлы, удаленные сборкой мусора, считаются листьями
+    uint64_t tree_size(const board_t& mtx, const bool color, const int turns_left, unordered_set<uint64_t>& visited)
+    {
+        if (!visited.insert(node_key(mtx, color, turns_left)).second)
+            return 0;
+        uint32_t phi, delta;
+        if (turns_left <= 0 || !lookup(mtx, color, turns_left, phi, delta))
+        {
+            proof_complete = proof_complete && turns_left <= 0;
+            return 1;
+        }
+        vector<board_t> children;
+        expand(mtx, color, children, nullptr);
+        uint64_t res = 1;
+        for (const auto& child : children)
+        {
+            uint32_t child_phi, child_delta;
+            lookup(child, !color, turns_left - 1, child_phi, child_delta);
+            if (phi == 0 && child_delta == 0)
+                return res + tree_size(child, !color, turns_left - 1, visited);
+            if (phi != 0)
+                res += tree_size(child, !color, turns_left - 1, visited);
+        }
+        return res;
+    }
+
+    // Все позиции после полного хода color (полные ходы Rules: побитые шашки снимаются после серии), без повторов
+    // Rules перечисляет ходы в постоянном порядке, поэтому результат и число узлов воспроизводимы
+    // moves: если задан, для каждой позиции - запись хода "xyx2y2,x2y2x3y3,..."
+    void expand(const board_t& mtx, const bool color, vector<board_t>& res, vector<string>* moves)
+    {
+        Logic::chain_list chains;
+        Logic::rules::generate(mtx, color, chains);
+        for (const Logic::chain_move& chain : chains)
+        {
+            const board_t next = Logic::rules::make_move(mtx, chain);
+            // Разные пути серии ударов могут привести в одну позицию
+            if (find(res.begin(), res.end(), next) != res.end())
+                continue;
+            res.push_back(next);
+            if (!moves)
+                continue;
+            string path;
+            for (const move_pos& pos : Logic::to_move_pos_list(chain))
+            {
+                path += (path.empty() ? "" : ",");
+                path += {char('0' + pos.x), char('0' + pos.y), char('0' + pos.x2), char('0' + pos.y2)};
+            }
+            moves->push_back(path);
+        }
+    }
+
+    static uint64_t node_key(const board_t& mtx, const bool color, const int turns_left)
+    {
+        const uint64_t key = Logic::position_hash(mtx, color) ^ (uint64_t(turns_left) * 0x9E3779B97F4A7C15ull);
+        return key ? key : 1;
+    }
+
+    Config config;
+    int max_turns;
+    uint64_t max_nodes;          // Предел узлов (0 - без предела)
+    vector<solver_entry> table;  // Таблица узлов ограниченного размера
+    size_t used = 0;             // Занятых записей
+    bool attacker = false;       // Цвет стороны, выигрыш которой доказывается
+    uint64_t nodes = 0;
+    uint64_t collections = 0;
+    bool aborted = false;
+    string best_move;
+    uint64_t proof_size = 0;
+    bool proof_complete = true;
+};
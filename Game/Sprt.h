@@ -0,0 +1,176 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Board.h"
+#include "Config.h"
+#include "Logic.h"
+#include "Match.h"
+
+// Класс Sprt - режим "sprt": A/B-проверка двух настроек поиска последовательным критерием отношения
+// правдоподобия (SPRT). Партии идут парами из общего набора начал (как в Match), пары играются параллельно
+// на всех ядрах. Результат пары (0..4 полуочка) учитывается целиком - пентаномиальная модель, поэтому
+// зависимость двух партий одного начала не завышает точность. Проверяются гипотезы H0: разница Эло A - B
+// равна Elo0 и H1: равна Elo1; проверка останавливается, когда LLR выходит за границы для ошибок Alpha и Beta
+class Sprt
+{
+public:
+    Sprt(const match_engine& a, const match_engine& b) : a(a), b(b)
+    {
+        Config config;
+        elo0 = config("SPRT", "Elo0");
+        elo1 = config("SPRT", "Elo1");
+        const double alpha = config("SPRT", "Alpha");
+        const double beta = config("SPRT", "Beta");
+        lower = log(beta / (1 - alpha));
+        upper = log((1 - beta) / alpha);
+        max_pairs = int(config("SPRT", "MaxGames")) / 2;
+        threads = config("SPRT", "Threads");
+        if (threads == 0)
+            threads = max(1u, thread::hardware_concurrency());
+        max_turns = config("Game", "MaxNumTurns");
+        draw_rule = Draw_rule(config);
+    }
+
+    int run()
+    {
+        cout << "A: " << a.optimization << " level " << a.level << ", B: " << b.optimization << " level " << b.level
+             << ", H0 Elo " << elo0 << ", H1 Elo " << elo1 << ", LLR bounds [" << lower << ", " << upper << "], "
+             << threads << " threads" << endl;
+
+        vector<thread> workers;
+        for (unsigned i = 0; i < threads; ++i)
+            workers.emplace_back(&Sprt::worker, this);
+        for (auto& worker : workers)
+            worker.join();
+
+        const int pairs = total_pairs();
+        const double llr_now = llr();
+        cout << "===========================\n";
+        cout << "Games              : " << pairs * 2 << " (" << wins << " / " << draws << " / " << losses << ")\n";
+        cout << "Pairs 0-4 points   : " << penta[0] << " " << penta[1] << " " << penta[2] << " " << penta[3] << " "
+             << penta[4] << "\n";
+        cout << "A Elo              : " << elo_text() << "\n";
+        cout << "LLR                : " << llr_now << " [" << lower << ", " << upper << "]\n";
+        cout << "Result             : "
+             << (llr_now >= upper ? "H1 accepted" : llr_now <= lower ? "H0 accepted" : "inconclusive (MaxGames)") << endl;
+        return 0;
+    }
+
+private:
+    // Играет пары партий, пока проверка не закончилась
+    void worker()
+    {
+        Config config_a = Match::engine_config(a), config_b = Match::engine_config(b);
+        Board board_a, board_b;
+        Logic logic_a(&board_a, &config_a), logic_b(&board_b, &config_b);
+        logic_a.Max_depth = a.level;
+        logic_b.Max_depth = b.level;
+        match_timing timing;
+        while (!done.load(memory_order_relaxed))
+        {
+            const int pair = next_pair.fetch_add(1);
+            if (pair >= max_pairs)
+                break;
+            const int first = Match::play_game(logic_a, logic_b, false, pair, max_turns, draw_rule, timing);
+            const int second = Match::play_game(logic_a, logic_b, true, pair, max_turns, draw_rule, timing);
+            add_pair(first, second);
+        }
+    }
+
+    // Учитывает пару партий и печатает текущее состояние
+    void add_pair(const int first, const int second)
+    {
+        lock_guard<mutex> lock(stats_mutex);
+        if (done.load(memory_order_relaxed))
+            return;  // Проверка уже закончилась, партии после остановки не учитываются
+        ++penta[first + second];
+        for (const int result : { first, second })
+        {
+            wins += result == 2;
+            draws += result == 1;
+            losses += result == 0;
+        }
+        const double llr_now = llr();
+        if (llr_now >= upper || llr_now <= lower)
+            done.store(true, memory_order_relaxed);
+        cout << "Games " << total_pairs() * 2 << ": +" << wins << " =" << draws << " -" << losses << "  Elo "
+             << elo_text() << "  LLR " << llr_now << " [" << lower << ", " << upper << "]" << endl;
+    }
+
+    int total_pairs() const
+    {
+        int res = 0;
+        for (const int n : penta)
+            res += n;
+        return res;
+    }
+
+    // Средний результат пары (доля очков) и его дисперсия
+    void pair_stats(double& mean, double& var) const
+    {
+        const int n = total_pairs();
+        mean = var = 0;
+        if (n == 0)
+            return;
+        for (int i = 0; i < 5; ++i)
+            mean += penta[i] * (i / 4.0);
+        mean /= n;
+        for (int i = 0; i < 5; ++i)
+            var += penta[i] * (i / 4.0 - mean) * (i / 4.0 - mean);
+        var /= n;
+    }
+
+    // Ожидаемая доля очков при разнице Эло elo
+    static double expected_score(const double elo)
+    {
+        return 1 / (1 + pow(10, -elo / 400));
+    }
+
+    // Логарифм отношения правдоподобия H1 к H0 (нормальное приближение по результатам пар)
+    double llr() const
+    {
+        double mean, var;
+        pair_stats(mean, var);
+        if (var <= 0)
+            return 0;
+        const double s0 = expected_score(elo0), s1 = expected_score(elo1);
+        return total_pairs() * (s1 - s0) * (2 * mean - s0 - s1) / (2 * var);
+    }
+
+    // Разница Эло A - B и половина 95% доверительного интервала
+    string elo_text() const
+    {
+        double mean, var;
+        pair_stats(mean, var);
+        const double error = 1.96 * sqrt(var / max(total_pairs(), 1));
+        const double elo = Match::elo(mean);
+        const double margin = (Match::elo(mean + error) - Match::elo(mean - error)) / 2;
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.1f +- %.1f", elo, margin);
+        return buf;
+    }
+
+    match_engine a;
+    match_engine b;
+    double elo0 = 0, elo1 = 0;
+    double lower = 0, upper = 0;  // Границы LLR: ниже - принимается H0, выше - H1
+    int max_pairs = 0;
+    unsigned threads = 1;
+    int max_turns = 0;
+    Draw_rule draw_rule{ 0, 0 };  // Правило ничьей из настроек (копия на партию)
+
+    atomic<int> next_pair{ 0 };  // Номер следующего начала
+    atomic<bool> done{ false };
+    mutex stats_mutex;
+    array<int, 5> penta{};       // Количество пар по сумме полуочков A (0..4)
+    int wins = 0, draws = 0, losses = 0;
+};
@@ -0,0 +1,151 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Структура trace_event - один завершенный интервал (span) трассировки
+struct trace_event
+{
+    const char* name;      // Имя интервала (строковый литерал)
+    const char* category;  // Категория: "search", "render", "input", "game"
+    long long start_ns;    // Начало относительно запуска трассировки
+    long long dur_ns;      // Длительность
+    const char* arg_name;  // Имя необязательного числового аргумента (nullptr - нет)
+    long long arg;         // Значение аргумента
+};
+
+// Класс Tracer собирает интервалы в буферы потоков и при завершении пишет их
+// в формате Chrome Trace Event (JSON), который открывается в chrome://tracing и Perfetto
+// Включается настройкой Log/Trace; в выключенном состоянии интервал стоит одной проверки флага
+class Tracer
+{
+public:
+    static Tracer& get()
+    {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    // Быстрая проверка, включена ли трассировка
+    static bool enabled()
+    {
+        return is_enabled.load(memory_order_relaxed);
+    }
+
+    // Включает трассировку; интервалы будут записаны в файл path при вызове write()
+    void enable(const string& trace_path)
+    {
+        lock_guard<mutex> lock(buffers_mutex);
+        path = trace_path;
+        start = chrono::steady_clock::now();
+        is_enabled.store(true, memory_order_release);
+    }
+
+    // Время от запуска трассировки в наносекундах
+    long long now_ns() const
+    {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    }
+
+    // Добавляет завершенный интервал в буфер текущего потока
+    void add(const trace_event& event)
+    {
+        thread_local Buffer* buffer = nullptr;
+        if (buffer == nullptr)
+            buffer = new_buffer();
+        buffer->events.push_back(event);
+    }
+
+    // Записывает все собранные интервалы в файл и выключает трассировку
+    // Вызывается при выходе из программы, когда потоки поиска уже завершены
+    void write()
+    {
+        if (!is_enabled.exchange(false))
+            return;
+        lock_guard<mutex> lock(buffers_mutex);
+        ofstream fout(path, ios_base::trunc);
+        fout << "{\"traceEvents\":[";
+        bool is_first = true;
+        for (const auto& buffer : buffers)
+        {
+            for (const auto& event : buffer->events)
+            {
+                if (!is_first)
+                    fout << ",";
+                is_first = false;
+                fout << "\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                     << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid << ",\"ts\":" << event.start_ns / 1000.0
+                     << ",\"dur\":" << event.dur_ns / 1000.0;
+                if (event.arg_name)
+                    fout << ",\"args\":{\"" << event.arg_name << "\":" << event.arg << "}";
+                fout << "}";
+            }
+        }
+        fout << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+    ~Tracer()
+    {
+        write();
+    }
+
+private:
+    // Буфер интервалов одного потока
+    struct Buffer
+    {
+        int tid;
+        vector<trace_event> events;
+    };
+
+    Tracer() = default;
+
+    // Создает и регистрирует буфер для нового потока
+    Buffer* new_buffer()
+    {
+        lock_guard<mutex> lock(buffers_mutex);
+        buffers.emplace_back(new Buffer{ int(buffers.size()) + 1, {} });
+        buffers.back()->events.reserve(1 << 16);
+        return buffers.back().get();
+    }
+
+    static inline atomic<bool> is_enabled{ false };
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    string path;
+    mutex buffers_mutex;                  // Защищает только список буферов, не сами интервалы
+    vector<unique_ptr<Buffer>> buffers;
+};
+
+// Класс trace_span записывает интервал от создания до уничтожения объекта
+// Пример: trace_span span("rerender", "render");
+class trace_span
+{
+public:
+    trace_span(const char* name, const char* category, const char* arg_name = nullptr, const long long arg = 0)
+    {
+        if (!Tracer::enabled())
+            return;
+        event = { name, category, Tracer::get().now_ns(), 0, arg_name, arg };
+        active = true;
+    }
+
+    ~trace_span()
+    {
+        if (!active || !Tracer::enabled())
+            return;
+        event.dur_ns = Tracer::get().now_ns() - event.start_ns;
+        Tracer::get().add(event);
+    }
+
+    trace_span(const trace_span&) = delete;
+    trace_span& operator=(const trace_span&) = delete;
+
+private:
+    trace_event event{};
+    bool active = false;
+};
@@ -0,0 +1,265 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Models/Tree_record.h"
+
+using namespace std;
+
+// Заголовок файла дампа: сигнатура и размер записи
+static const char TREE_DUMP_MAGIC[8] = { 'C', 'K', 'T', 'R', 'E', 'E', '0', '1' };
+
+// Класс Tree_writer - потоковая запись дампа дерева в файл
+// Поиски отдают записи пачками, файл пишет фоновый поток, поэтому поиск не ждет диска
+// Один объект на файл: все экземпляры Logic с одинаковой настройкой пишут в один файл
+class Tree_writer
+{
+public:
+    // Открывает (и очищает) файл дампа; nullptr, если файл не открылся
+    static Tree_writer* open(const string& path)
+    {
+        static mutex writers_mutex;
+        static map<string, unique_ptr<Tree_writer>> writers;
+        lock_guard<mutex> lock(writers_mutex);
+        auto it = writers.find(path);
+        if (it == writers.end())
+        {
+            unique_ptr<Tree_writer> writer(new Tree_writer(path));
+            if (!writer->fout)
+                writer.reset();
+            it = writers.emplace(path, move(writer)).first;
+        }
+        return it->second.get();
+    }
+
+    ~Tree_writer()
+    {
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            is_running = false;
+        }
+        queue_cv.notify_one();
+        if (worker.joinable())
+            worker.join();
+    }
+
+    // Номер следующего поиска (уникален в пределах файла)
+    uint32_t next_search()
+    {
+        return searches.fetch_add(1, memory_order_relaxed);
+    }
+
+    // Ставит пачку записей в очередь на запись
+    void submit(vector<tree_record>&& batch)
+    {
+        if (batch.empty())
+            return;
+        {
+            lock_guard<mutex> lock(queue_mutex);
+            queue.push_back(move(batch));
+        }
+        queue_cv.notify_one();
+    }
+
+private:
+    explicit Tree_writer(const string& path) : fout(path, ios_base::binary | ios_base::trunc)
+    {
+        if (!fout)
+            return;
+        const uint32_t record_size = sizeof(tree_record);
+        fout.write(TREE_DUMP_MAGIC, sizeof(TREE_DUMP_MAGIC));
+        fout.write(reinterpret_cast<const char*>(&record_size), sizeof(record_size));
+        worker = thread(&Tree_writer::write_loop, this);
+    }
+
+    void write_loop()
+    {
+        unique_lock<mutex> lock(queue_mutex);
+        while (true)
+        {
+            queue_cv.wait(lock, [this] { return !queue.empty() || !is_running; });
+            if (queue.empty())
+                break;
+            vector<tree_record> batch = move(queue.front());
+            queue.pop_front();
+            lock.unlock();
+            fout.write(reinterpret_cast<const char*>(batch.data()), streamsize(batch.size() * sizeof(tree_record)));
+            lock.lock();
+            if (queue.empty())
+                fout.flush();
+        }
+        fout.flush();
+    }
+
+    ofstream fout;
+    atomic<uint32_t> searches{ 0 };
+    mutex queue_mutex;
+    condition_variable queue_cv;
+    deque<vector<tree_record>> queue;
+    bool is_running = true;
+    thread worker;
+};
+
+// Класс Tree_dump - запись дерева одного поиска (свой у каждого экземпляра Logic)
+// Записываются узлы не глубже max_ply ходов от корня; на глубине sample_ply поддерево попадает в дамп
+// с вероятностью sample_rate. Размер поддерева и потраченные до отсечения узлы считаются точно, даже если
+// потомки не записаны. Незаписываемое поддерево стоит одного счетчика на узел
+class Tree_dump
+{
+public:
+    Tree_dump(Tree_writer* writer, const int max_ply, const int sample_ply, const double sample_rate)
+        : writer(writer), max_ply(max_ply), sample_ply(sample_ply),
+          sample_threshold(sample_rate >= 1 ? UINT64_MAX : uint64_t(max(0.0, sample_rate) * 18446744073709551616.0))
+    {
+        stack.reserve(128);
+        batch.reserve(BATCH);
+    }
+
+    // Начало нового поиска
+    void begin_search()
+    {
+        search = writer->next_search();
+        next_id = 0;
+        skip_depth = 0;
+        stack.clear();
+    }
+
+    // Конец поиска: оставшиеся записи отдаются на запись
+    void end_search()
+    {
+        flush();
+    }
+
+    // Вход в узел: ply - ходов от корня, remaining - оставшаяся глубина, nodes - счетчик узлов поиска
+    void enter(const int ply, const int remaining, const int reduced, const double alpha, const double beta,
+        const uint64_t nodes)
+    {
+        if (skip_depth || ply > max_ply || (ply == sample_ply && !sample()))
+        {
+            ++skip_depth;
+            return;
+        }
+        frame f;
+        f.rec.search = search;
+        f.rec.id = next_id++;
+        if (!stack.empty())
+        {
+            const frame& parent = stack.back();
+            f.rec.parent = parent.rec.id;
+            f.rec.from = parent.child_from;
+            f.rec.to = parent.child_to;
+            f.rec.captures = parent.child_captures;
+        }
+        f.rec.alpha = float(alpha);
+        f.rec.beta = float(beta);
+        f.rec.ply = uint8_t(ply);
+        f.rec.remaining = int8_t(max(-128, min(127, remaining)));
+        f.rec.reduced = uint8_t(reduced);
+        f.start_nodes = nodes;
+        stack.push_back(f);
+    }
+
+    // Следующий ребенок текущего узла - ход from -> to с captures взятиями
+    void set_move(const int from, const int to, const int captures, const uint64_t nodes)
+    {
+        if (skip_depth)
+            return;
+        frame& f = stack.back();
+        f.child_from = uint8_t(from);
+        f.child_to = uint8_t(to);
+        f.child_captures = uint8_t(captures);
+        f.child_nodes = nodes;
+    }
+
+    // Проверочный поиск в той же позиции (ProbCut) - ребенок без хода
+    void set_probe(const uint64_t nodes)
+    {
+        set_move(tree_record::NO_MOVE, tree_record::NO_MOVE, 0, nodes);
+    }
+
+    // Количество ходов текущего узла
+    void set_moves(const size_t moves)
+    {
+        if (!skip_depth)
+            stack.back().rec.moves = uint8_t(min<size_t>(moves, 255));
+    }
+
+    // Причина окончания перебора текущего узла; cut_move - номер хода, давшего отсечение
+    void set_cut(const tree_cut cut, const int cut_move = tree_record::NO_MOVE)
+    {
+        if (skip_depth)
+            return;
+        frame& f = stack.back();
+        f.rec.cut = cut;
+        f.rec.cut_move = uint8_t(cut_move);
+        if (cut == tree_cut::CUTOFF)
+            f.rec.wasted = uint32_t(f.child_nodes - f.start_nodes - 1);
+    }
+
+    // Выход из узла с оценкой score
+    void leave(const double score, const uint64_t nodes)
+    {
+        if (skip_depth)
+        {
+            --skip_depth;
+            return;
+        }
+        tree_record rec = stack.back().rec;
+        rec.subtree = uint32_t(nodes - stack.back().start_nodes);
+        rec.score = float(score);
+        stack.pop_back();
+        batch.push_back(rec);
+        if (batch.size() >= BATCH)
+            flush();
+    }
+
+private:
+    static constexpr size_t BATCH = 4096;  // Записей в пачке
+
+    // Узел на пути от корня
+    struct frame
+    {
+        tree_record rec;
+        uint64_t start_nodes = 0;  // Счетчик узлов при входе
+        uint64_t child_nodes = 0;  // Счетчик узлов перед текущим ребенком
+        uint8_t child_from = tree_record::NO_MOVE;
+        uint8_t child_to = tree_record::NO_MOVE;
+        uint8_t child_captures = 0;
+    };
+
+    void flush()
+    {
+        writer->submit(move(batch));
+        batch = vector<tree_record>();
+        batch.reserve(BATCH);
+    }
+
+    // Попадает ли поддерево в выборку (xorshift с постоянным зерном - дамп повторяется)
+    bool sample()
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return rng <= sample_threshold;
+    }
+
+    Tree_writer* writer;
+    int max_ply;
+    int sample_ply;
+    uint64_t sample_threshold;
+    uint64_t rng = 0x9E3779B97F4A7C15ull;
+    uint32_t search = 0;
+    uint32_t next_id = 0;
+    int skip_depth = 0;  // Глубина внутри незаписываемого поддерева
+    vector<frame> stack;
+    vector<tree_record> batch;
+};
@@ -0,0 +1,244 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "../Models/Move.h"
+#include "../Models/Tree_record.h"
+#include "Tree_dump.h"
+
+// Класс Tree_summary - режим "tree": сводка по дампу дерева поиска (настройка TreeDump)
+// Показывает, как узлы заканчивают перебор, каким по счету ходом происходят отсечения, сколько узлов
+// потрачено на ходы до отсекшего (лишние поддеревья при идеальном порядке ходов), самые большие
+// такие потери с путем от корня, а также лишнюю работу ProbCut и повторных поисков LMR
+class Tree_summary
+{
+public:
+    Tree_summary(const string& path, const int top) : path(path), top(top)
+    {
+    }
+
+    int run()
+    {
+        if (!load())
+        {
+            cerr << "Can't read tree dump " << path << endl;
+            return 1;
+        }
+        index.reserve(records.size());
+        for (size_t i = 0; i < records.size(); ++i)
+            index[key(records[i].search, records[i].id)] = i;
+
+        print_totals();
+        print_plies();
+        print_wasted();
+        print_rechecks();
+        return 0;
+    }
+
+private:
+    static constexpr int MAX_PLIES = 64;
+
+    bool load()
+    {
+        ifstream fin(path, ios_base::binary);
+        char magic[sizeof(TREE_DUMP_MAGIC)];
+        uint32_t record_size = 0;
+        if (!fin.read(magic, sizeof(magic)) || !equal(magic, magic + sizeof(magic), TREE_DUMP_MAGIC) ||
+            !fin.read(reinterpret_cast<char*>(&record_size), sizeof(record_size)) || record_size != sizeof(tree_record))
+        {
+            return false;
+        }
+        tree_record rec;
+        while (fin.read(reinterpret_cast<char*>(&rec), sizeof(rec)))
+            records.push_back(rec);
+        return true;
+    }
+
+    static uint64_t key(const uint32_t search, const uint32_t id)
+    {
+        return (uint64_t(search) << 32) | id;
+    }
+
+    // Ход в обозначениях "xyx2y2" (как в режиме render); проверочный поиск ProbCut - "probe"
+    static string move_text(const tree_record& rec)
+    {
+        if (rec.from == tree_record::NO_MOVE)
+            return rec.ply ? "probe" : "root";
+        string res;
+        for (const int v : { dark_cell_x(rec.from), dark_cell_y(rec.from), dark_cell_x(rec.to), dark_cell_y(rec.to) })
+            res += char('0' + v);
+        return res;
+    }
+
+    // Путь от корня до узла
+    string path_text(const tree_record& rec) const
+    {
+        vector<string> moves;
+        const tree_record* cur = &rec;
+        while (cur->parent != tree_record::NO_PARENT)
+        {
+            moves.push_back(move_text(*cur));
+            const auto it = index.find(key(cur->search, cur->parent));
+            if (it == index.end())
+                break;
+            cur = &records[it->second];
+        }
+        string res;
+        for (auto it = moves.rbegin(); it != moves.rend(); ++it)
+            res += (res.empty() ? "" : " ") + *it;
+        return res.empty() ? "root" : res;
+    }
+
+    static double percent(const uint64_t part, const uint64_t total)
+    {
+        return total ? 100.0 * part / total : 0;
+    }
+
+    void print_totals() const
+    {
+        static const char* reasons[] = { "all moves", "cutoff", "leaf", "no moves", "futility", "probcut", "stopped", "mate dist" };
+        uint64_t searches = 0, searched = 0;
+        array<uint64_t, 8> by_reason{};
+        for (const tree_record& rec : records)
+        {
+            if (rec.parent == tree_record::NO_PARENT)
+            {
+                ++searches;
+                searched += rec.subtree;
+            }
+            ++by_reason[size_t(rec.cut)];
+        }
+        cout << fixed << setprecision(1);
+        cout << "Searches        : " << searches << "\n";
+        cout << "Nodes searched  : " << searched << "\n";
+        cout << "Nodes recorded  : " << records.size() << "\n";
+        cout << "Recorded nodes by how they ended:\n";
+        for (size_t i = 0; i < by_reason.size(); ++i)
+        {
+            if (by_reason[i])
+                cout << "  " << setw(10) << left << reasons[i] << right << by_reason[i] << " ("
+                     << percent(by_reason[i], records.size()) << "%)\n";
+        }
+
+        // Отсечение не первым ходом - порядок ходов мог быть лучше
+        array<uint64_t, 5> by_move{};
+        uint64_t cutoffs = 0;
+        for (const tree_record& rec : records)
+        {
+            if (rec.cut != tree_cut::CUTOFF)
+                continue;
+            ++cutoffs;
+            const int n = rec.cut_move;
+            ++by_move[n == 0 ? 0 : n == 1 ? 1 : n == 2 ? 2 : n < 7 ? 3 : 4];
+        }
+        static const char* groups[] = { "#1", "#2", "#3", "#4-7", "#8+" };
+        cout << "Cutoffs by move number (" << cutoffs << " cutoffs, late: " << cutoffs - by_move[0] << "):\n";
+        for (size_t i = 0; i < by_move.size(); ++i)
+            cout << "  " << setw(10) << left << groups[i] << right << by_move[i] << " (" << percent(by_move[i], cutoffs)
+                 << "%)\n";
+    }
+
+    // По глубине: узлы, отсечения, доля отсечений первым ходом и доля узлов, потраченных до отсекшего хода
+    void print_plies() const
+    {
+        struct ply_totals
+        {
+            uint64_t nodes = 0, subtree = 0, cutoffs = 0, first = 0, wasted = 0;
+        };
+        array<ply_totals, MAX_PLIES> plies{};
+        int max_ply = 0;
+        for (const tree_record& rec : records)
+        {
+            ply_totals& p = plies[min<int>(rec.ply, MAX_PLIES - 1)];
+            max_ply = max<int>(max_ply, rec.ply);
+            ++p.nodes;
+            p.subtree += rec.subtree;
+            if (rec.cut == tree_cut::CUTOFF)
+            {
+                ++p.cutoffs;
+                p.first += rec.cut_move == 0;
+                p.wasted += rec.wasted;
+            }
+        }
+        cout << "ply   nodes      cutoffs    first-move  wasted nodes  wasted %\n";
+        for (int ply = 0; ply <= min(max_ply, MAX_PLIES - 1); ++ply)
+        {
+            const ply_totals& p = plies[ply];
+            cout << setw(3) << ply << setw(10) << p.nodes << setw(11) << p.cutoffs << setw(11)
+                 << percent(p.first, p.cutoffs) << "%" << setw(14) << p.wasted << setw(9) << percent(p.wasted, p.subtree)
+                 << "%\n";
+        }
+    }
+
+    // Самые большие потери: узлы, где до отсекшего хода просмотрено больше всего узлов
+    void print_wasted() const
+    {
+        vector<const tree_record*> cut;
+        for (const tree_record& rec : records)
+        {
+            if (rec.cut == tree_cut::CUTOFF && rec.wasted)
+                cut.push_back(&rec);
+        }
+        const size_t count = min(cut.size(), size_t(max(top, 0)));
+        partial_sort(cut.begin(), cut.begin() + count, cut.end(),
+            [](const tree_record* l, const tree_record* r) { return l->wasted > r->wasted; });
+        cout << "Largest wasted subtrees (nodes searched before the cutoff move):\n";
+        for (size_t i = 0; i < count; ++i)
+        {
+            const tree_record& rec = *cut[i];
+            cout << "  " << rec.wasted << " of " << rec.subtree << " nodes, cut by move #" << rec.cut_move + 1 << " of "
+                 << int(rec.moves) << ", search " << rec.search << " ply " << int(rec.ply) << ": " << path_text(rec)
+                 << "\n";
+        }
+    }
+
+    // Лишняя работа O2: проверочные поиски ProbCut без отсечения и сокращенные поиски LMR,
+    // после которых ход пришлось пересчитать на полную глубину
+    void print_rechecks() const
+    {
+        uint64_t probes = 0, probe_cuts = 0, probe_nodes = 0;
+        map<tuple<uint32_t, uint32_t, uint8_t, uint8_t>, const tree_record*> first_child;  // (поиск, родитель, ход)
+        uint64_t researches = 0, research_nodes = 0;
+        for (const tree_record& rec : records)
+        {
+            if (rec.cut == tree_cut::PROBCUT)
+                ++probe_cuts;
+            if (rec.parent == tree_record::NO_PARENT)
+                continue;
+            if (rec.from == tree_record::NO_MOVE)
+            {
+                ++probes;
+                probe_nodes += rec.subtree;
+                continue;
+            }
+            const auto child_key = make_tuple(rec.search, rec.parent, rec.from, rec.to);
+            auto it = first_child.find(child_key);
+            if (it == first_child.end())
+            {
+                first_child.emplace(child_key, &rec);
+            }
+            else if (it->second->reduced != rec.reduced)
+            {
+                ++researches;
+                research_nodes += (it->second->reduced > rec.reduced ? it->second : &rec)->subtree;
+            }
+        }
+        cout << "ProbCut probes  : " << probes << ", cut " << probe_cuts << " (" << percent(probe_cuts, probes) << "%), "
+             << probe_nodes << " nodes\n";
+        cout << "LMR re-searches : " << researches << ", " << research_nodes << " nodes in discarded reduced searches"
+             << endl;
+    }
+
+    string path;
+    int top;
+    vector<tree_record> records;
+    unordered_map<uint64_t, size_t> index;  // (поиск, номер узла) -> номер записи
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Структура cache_record - запись файла кэша анализа (48 байт)
+// Записи только дописываются в конец файла; последняя запись с тем же ключом заменяет предыдущие
+struct cache_record
+{
+    static constexpr int MAX_TURNS = 12;  // Максимальная длина серии ходов в записи
+
+    uint64_t key = 0;               // Хеш позиции, очереди хода, глубины и режима поиска
+    int16_t score = 0;              // Оценка позиции с точки зрения ходящего (Score.h)
+    uint8_t depth = 0;              // Глубина поиска (уровень бота)
+    uint8_t count = 0;              // Количество ходов в серии
+    uint16_t turns[MAX_TURNS] = {}; // Лучшая серия ходов (packed_move)
+    uint16_t reserved[4] = {};
+    uint32_t checksum = 0;          // Контрольная сумма остальных полей, 0 - запись не дописана
+
+    // Контрольная сумма FNV-1a по всем полям, кроме checksum (никогда не равна 0)
+    uint32_t calc_checksum() const
+    {
+        unsigned char bytes[sizeof(cache_record)];
+        memcpy(bytes, this, sizeof(cache_record));
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < offsetof(cache_record, checksum); ++i)
+            h = (h ^ bytes[i]) * 16777619u;
+        return h ? h : 1;
+    }
+
+    // Запись полностью записана и не повреждена
+    bool is_valid() const
+    {
+        return checksum != 0 && checksum == calc_checksum();
+    }
+};
+static_assert(sizeof(cache_record) == 48, "cache_record layout is part of the file format");
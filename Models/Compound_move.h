@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Move.h"
+
+// Структура compound_move - полный ход: простой ход или вся серия взятий одной шашкой
+// CELLS - количество игровых клеток доски, MAX_CAPTURES - наибольшее число взятий за ход
+// Побитые шашки снимаются с доски после окончания серии (их нельзя перепрыгнуть дважды)
+template <int CELLS, int MAX_CAPTURES> struct compound_move
+{
+    static_assert(CELLS <= 64, "captured cells are stored in a 64-bit mask");
+
+    uint64_t captured = 0;                    // Маска побитых шашек по номерам клеток
+    POS_T from = -1, to = -1;                 // Начальная и конечная клетки
+    uint8_t count = 0;                        // Количество взятий (0 - простой ход)
+    bool promotes = false;                    // Шашка становится дамкой
+    std::array<POS_T, MAX_CAPTURES> path{};   // Клетки приземления после каждого взятия (последняя - to)
+    std::array<POS_T, MAX_CAPTURES> beaten{}; // Побитые шашки в порядке взятия
+
+    // Ходы с одинаковыми начальной и конечной клетками и набором побитых шашек считаются одним ходом,
+    // даже если шашка шла разными путями
+    bool same_as(const compound_move& other) const
+    {
+        return from == other.from && to == other.to && captured == other.captured;
+    }
+};
+
+// Структура fixed_list - список фиксированной вместимости на стеке (как move_list, для любых ходов)
+template <class T, size_t N> struct fixed_list
+{
+    static const size_t CAPACITY = N;
+
+    T items[N];
+    size_t size = 0;
+
+    void clear()
+    {
+        size = 0;
+    }
+
+    void push_back(const T& item)
+    {
+        items[size++] = item;
+    }
+
+    bool empty() const { return size == 0; }
+    T* begin() { return items; }
+    T* end() { return items + size; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + size; }
+};
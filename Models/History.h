@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <stdint.h>
+
+#include "Move.h"
+
+// Структура history_entry - компактная запись одного перемещения в журнале ходов
+// Вместо снимка всей доски хранит упакованный ход, побитую шашку и признак превращения,
+// чего достаточно, чтобы отменить или повторить перемещение без выделения памяти
+struct history_entry
+{
+    uint16_t move = 0;         // Упакованный ход: биты 0-5 - начальная клетка, биты 6-11 - конечная (x * 8 + y)
+    uint8_t beaten = NO_CELL;  // Клетка побитой шашки (x * 8 + y) или NO_CELL, если ход без боя
+    uint8_t captured = 0;      // Тип побитой шашки (1-4), 0 - ход без боя
+    uint8_t promoted = 0;      // 1, если шашка превратилась в дамку этим ходом
+    uint8_t beat_series = 0;   // Номер удара в серии (0 - обычный ход)
+
+    static constexpr uint8_t NO_CELL = 0xFF;  // Признак отсутствия клетки
+
+    history_entry() = default;
+
+    // Конструктор: упаковывает ход, тип побитой шашки и признак превращения
+    history_entry(const move_pos& turn, const POS_T captured, const bool promoted, const int beat_series)
+        : move(uint16_t(cell(turn.x, turn.y) | (cell(turn.x2, turn.y2) << 6))),
+        beaten(turn.xb != -1 ? cell(turn.xb, turn.yb) : NO_CELL), captured(uint8_t(captured)),
+        promoted(promoted), beat_series(uint8_t(beat_series))
+    {
+    }
+
+    // Координаты начальной, конечной клетки и побитой шашки
+    POS_T x() const { return POS_T((move & 63) / 8); }
+    POS_T y() const { return POS_T((move & 63) % 8); }
+    POS_T x2() const { return POS_T((move >> 6) / 8); }
+    POS_T y2() const { return POS_T((move >> 6) % 8); }
+    POS_T xb() const { return beaten == NO_CELL ? POS_T(-1) : POS_T(beaten / 8); }
+    POS_T yb() const { return beaten == NO_CELL ? POS_T(-1) : POS_T(beaten % 8); }
+
+    // Распаковывает запись обратно в структуру хода
+    move_pos to_move() const
+    {
+        return move_pos(x(), y(), x2(), y2(), xb(), yb());
+    }
+
+    // Номер клетки доски 8x8 по координатам
+    static uint8_t cell(const POS_T x, const POS_T y)
+    {
+        return uint8_t(x * 8 + y);
+    }
+};
+
+// Опорный кадр журнала - упакованная позиция на 32 игровых (темных) клетках
+// Клетка (x, y) хранится по индексу x * 4 + y / 2
+typedef std::array<POS_T, 32> history_keyframe;
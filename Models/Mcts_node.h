@@ -0,0 +1,34 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+// Структура mcts_node - узел дерева поиска Монте-Карло (24 байта)
+// Узлы лежат подряд в одном массиве; дети узла занимают отрезок [first_child, first_child + child_count)
+// Ребро дерева - полный ход (вся серия ударов), поэтому игроки в узлах чередуются
+struct mcts_node
+{
+    // Состояние раскрытия узла
+    static constexpr uint8_t LEAF = 0;       // Дети не созданы
+    static constexpr uint8_t EXPANDING = 1;  // Дети создаются другим потоком
+    static constexpr uint8_t EXPANDED = 2;   // Дети созданы (child_count == 0 - конец партии)
+
+    uint64_t turn = 0;                  // Ход, ведущий в узел (упакованный полный ход, см. Mcts::pack)
+    std::atomic<uint32_t> visits{ 0 };  // Посещения, включая незавершенные (виртуальные проигрыши)
+    std::atomic<uint32_t> score{ 0 };   // Очки игрока mover в полуочках: победа 2, ничья 1
+    uint32_t first_child = 0;           // Номер первого ребенка в массиве узлов
+    uint8_t child_count = 0;            // Количество детей
+    uint8_t mover = 0;                  // Цвет игрока, сделавшего ход turn (1 - черные)
+    std::atomic<uint8_t> state{ LEAF };
+
+    // Подготавливает узел к новому поиску
+    void reset(const uint64_t new_turn, const bool new_mover)
+    {
+        visits.store(0, std::memory_order_relaxed);
+        score.store(0, std::memory_order_relaxed);
+        first_child = 0;
+        turn = new_turn;
+        child_count = 0;
+        mover = new_mover;
+        state.store(LEAF, std::memory_order_relaxed);
+    }
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <stdint.h>
 #include <stdlib.h>
 
 // Определение типа для координат на доске
@@ -42,4 +43,103 @@ struct move_pos
     {
         return !(*this == other);
     }
-};
\ No newline at end of file
+};
+
+// Номер игровой (темной) клетки доски 8x8: от 0 до 31, по 4 клетки в строке
+constexpr POS_T dark_cell(const POS_T x, const POS_T y)
+{
+    return POS_T(x * 4 + y / 2);
+}
+
+// Строка игровой клетки по ее номеру
+constexpr POS_T dark_cell_x(const POS_T cell)
+{
+    return POS_T(cell / 4);
+}
+
+// Столбец игровой клетки по ее номеру (в четных строках темные клетки стоят в нечетных столбцах)
+constexpr POS_T dark_cell_y(const POS_T cell)
+{
+    return POS_T(2 * (cell % 4) + 1 - (cell / 4) % 2);
+}
+
+// Структура packed_move - ход, упакованный в 16 бит для поиска без выделения памяти
+// Биты 0-4 - начальная клетка, 5-9 - конечная, 10-14 - побитая шашка, бит 15 - признак боя
+// Клетки задаются номерами игровых клеток (dark_cell)
+struct packed_move
+{
+    uint16_t data = 0;
+
+    packed_move() = default;
+
+    // Ход без боя
+    packed_move(const POS_T from, const POS_T to) : data(uint16_t(from | (to << 5)))
+    {
+    }
+
+    // Ход с боем
+    packed_move(const POS_T from, const POS_T to, const POS_T beaten)
+        : data(uint16_t(from | (to << 5) | (beaten << 10) | (1 << 15)))
+    {
+    }
+
+    // Упаковывает ход из структуры move_pos
+    explicit packed_move(const move_pos& turn)
+        : packed_move(turn.xb == -1 ? packed_move(dark_cell(turn.x, turn.y), dark_cell(turn.x2, turn.y2))
+                                    : packed_move(dark_cell(turn.x, turn.y), dark_cell(turn.x2, turn.y2),
+                                                  dark_cell(turn.xb, turn.yb)))
+    {
+    }
+
+    POS_T from() const { return POS_T(data & 31); }
+    POS_T to() const { return POS_T((data >> 5) & 31); }
+    POS_T beaten() const { return POS_T((data >> 10) & 31); }
+    bool is_beat() const { return data >> 15; }
+
+    // Распаковывает ход в структуру move_pos
+    move_pos to_move_pos() const
+    {
+        if (!is_beat())
+            return move_pos(dark_cell_x(from()), dark_cell_y(from()), dark_cell_x(to()), dark_cell_y(to()));
+        return move_pos(dark_cell_x(from()), dark_cell_y(from()), dark_cell_x(to()), dark_cell_y(to()),
+            dark_cell_x(beaten()), dark_cell_y(beaten()));
+    }
+
+    bool operator==(const packed_move& other) const
+    {
+        return data == other.data;
+    }
+
+    bool operator!=(const packed_move& other) const
+    {
+        return data != other.data;
+    }
+};
+
+// Структура move_list - список ходов фиксированной вместимости, размещаемый на стеке
+// Используется в поиске вместо vector<move_pos>, чтобы не выделять память в каждом узле
+struct move_list
+{
+    static const size_t CAPACITY = 128;  // С запасом больше максимального числа ходов в позиции 8x8
+
+    packed_move items[CAPACITY];
+    size_t size = 0;
+    bool have_beats = false;  // Есть ли среди ходов взятия
+
+    void clear()
+    {
+        size = 0;
+        have_beats = false;
+    }
+
+    void push_back(const packed_move turn)
+    {
+        items[size++] = turn;
+    }
+
+    bool empty() const { return size == 0; }
+    packed_move* begin() { return items; }
+    packed_move* end() { return items + size; }
+    const packed_move* begin() const { return items; }
+    const packed_move* end() const { return items + size; }
+};
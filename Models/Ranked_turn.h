@@ -0,0 +1,12 @@
+#pragma once
+#include <vector>
+
+#include "Move.h"
+
+// Структура ranked_turn - ход корня с точной оценкой (результат многолинейного поиска Logic::find_ranked_turns)
+struct ranked_turn
+{
+    std::vector<move_pos> turns;            // Ход: вся серия взятий по отдельным ударам
+    int score = 0;                          // Оценка хода с точки зрения ходящего (Score.h)
+    std::vector<std::vector<move_pos>> pv;  // Главная линия после хода: ответ соперника, затем ход ходящего и т.д.
+};
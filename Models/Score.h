@@ -0,0 +1,30 @@
+#pragma once
+#include <stdint.h>
+
+// Оценки поиска - целые числа в сотых долях шашки с точки зрения бота: шашка - 100, дамка - 400
+// (с NumberAndPotential - 500 и бонус за продвижение). Выигрыш и проигрыш кодируются расстоянием
+// от корня поиска: SCORE_WIN - n - выигрыш на ходу n, -SCORE_WIN + n - проигрыш; чем быстрее выигрыш,
+// тем выше оценка. Любая оценка помещается в 16 бит (кэш анализа, обучающие позиции)
+constexpr int SCORE_WIN = 30000;      // Выигрыш в корне (на практике - минус расстояние)
+constexpr int SCORE_INF = 32000;      // Границы окна поиска: больше по модулю любой оценки
+constexpr int SCORE_DRAW = 0;         // Ничья: материал равен
+constexpr int SCORE_MAX_DISTANCE = 1000;  // Оценки ближе к SCORE_WIN - выигрыш или проигрыш
+static_assert(SCORE_INF <= INT16_MAX, "scores are stored in 16 bits");
+
+// Выигрыш для бота (на расстоянии score_distance)
+inline bool is_win_score(const int score)
+{
+    return score >= SCORE_WIN - SCORE_MAX_DISTANCE;
+}
+
+// Проигрыш для бота
+inline bool is_loss_score(const int score)
+{
+    return score <= -SCORE_WIN + SCORE_MAX_DISTANCE;
+}
+
+// Через сколько ходов от корня выигрыш или проигрыш (только для is_win_score / is_loss_score)
+inline int score_distance(const int score)
+{
+    return score > 0 ? SCORE_WIN - score : SCORE_WIN + score;
+}
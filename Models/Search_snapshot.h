@@ -0,0 +1,32 @@
+#pragma once
+#include <array>
+#include <stdint.h>
+#include <type_traits>
+
+// Структура search_snapshot - состояние идущего поиска бота для панели HUD (Search_monitor)
+// Фиксированного размера и без указателей: копируется из потока поиска побайтно
+struct search_snapshot
+{
+    static constexpr int MAX_SEGMENTS = 24;  // Отрезков главной линии (каждый удар серии - отдельный отрезок)
+
+    // Отрезок главной линии: удар или ход с клетки from на клетку to (клетки dark_cell)
+    struct segment
+    {
+        uint8_t from, to;
+        uint8_t ply;  // Номер хода в линии: четные - ходы бота, нечетные - ответы соперника
+    };
+
+    int64_t start_ticks = 0;  // Начало поиска (steady_clock)
+    uint64_t nodes = 0;       // Узлов (для MCTS - симуляций)
+    double elapsed_ms = 0;    // Время поиска (заполняет Search_monitor::read)
+    int32_t score = 0;        // Оценка лучшего хода для бота (Score.h: сотые доли шашки, 0 - равенство)
+    int32_t depth = 0;        // Глубина поиска (уровень бота)
+    int32_t root_move = 0;    // Просмотрено ходов корня
+    int32_t root_moves = 0;   // Всего ходов корня
+    bool color = false;       // Цвет бота
+    bool running = false;     // Поиск идет
+    bool has_score = false;   // Оценка и главная линия уже есть
+    uint8_t segments = 0;     // Отрезков главной линии
+    std::array<segment, MAX_SEGMENTS> pv{};
+};
+static_assert(std::is_trivially_copyable<search_snapshot>::value, "search_snapshot is copied word by word");
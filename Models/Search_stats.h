@@ -0,0 +1,103 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <stdint.h>
+
+#include <nlohmann/json.hpp>
+
+// Переключатель сбора статистики поиска во время компиляции
+// По умолчанию счетчики включены в отладочной сборке и полностью удаляются в релизной (NDEBUG)
+// Можно задать явно: -DSEARCH_STATS=1 или -DSEARCH_STATS=0
+#ifndef SEARCH_STATS
+#ifdef NDEBUG
+#define SEARCH_STATS 0
+#else
+#define SEARCH_STATS 1
+#endif
+#endif
+
+// Код внутри STATS_ONLY(...) компилируется только при включенной статистике
+#if SEARCH_STATS
+#define STATS_ONLY(...) __VA_ARGS__
+#else
+#define STATS_ONLY(...)
+#endif
+
+// Структура search_stats хранит счетчики одного поиска хода бота
+struct search_stats
+{
+    static const size_t MAX_PLY = 64;  // Максимальная глубина, для которой ведется счет узлов
+
+    uint64_t nodes = 0;               // Количество посещенных узлов дерева
+    uint64_t leaf_evals = 0;          // Количество оценок листьев (вызовов calc_score)
+    uint64_t beta_cutoffs = 0;        // Количество альфа-бета отсечений
+    uint64_t first_move_cutoffs = 0;  // Отсечения, случившиеся на первом же ходе узла
+    uint64_t chain_nodes = 0;         // Ходы-серии из нескольких взятий
+    int max_chain = 0;                // Самая длинная серия взятий в дереве
+    int max_depth = 0;                // Глубина поиска
+    std::array<uint64_t, MAX_PLY> depth_nodes{};  // Узлы по глубинам: 0 - корень, d + 1 - глубина d
+
+    int64_t movegen_ns = 0;  // Время генерации ходов
+    int64_t eval_ns = 0;     // Время оценки позиций
+    int64_t total_ns = 0;    // Общее время поиска
+
+    // Сбрасывает все счетчики перед новым поиском
+    void clear()
+    {
+        *this = search_stats();
+    }
+
+    // Учитывает посещение узла на глубине ply (0 - корень)
+    void add_node(const size_t ply)
+    {
+        ++nodes;
+        ++depth_nodes[ply < MAX_PLY ? ply : MAX_PLY - 1];
+    }
+
+    // Формирует одну JSON-запись со всеми счетчиками
+    nlohmann::json to_json() const
+    {
+        nlohmann::json res;
+        res["nodes"] = nodes;
+        res["leaf_evals"] = leaf_evals;
+        res["beta_cutoffs"] = beta_cutoffs;
+        res["first_move_cutoff_rate"] = beta_cutoffs ? double(first_move_cutoffs) / beta_cutoffs : 0.0;
+        res["chain_nodes"] = chain_nodes;
+        res["max_chain"] = max_chain;
+        res["depth"] = max_depth;
+
+        // Эффективный коэффициент ветвления: отношение числа узлов соседних глубин
+        nlohmann::json depth_list = nlohmann::json::array(), ebf = nlohmann::json::array();
+        for (size_t i = 0; i < MAX_PLY && depth_nodes[i]; ++i)
+        {
+            depth_list.push_back(depth_nodes[i]);
+            if (i + 1 < MAX_PLY && depth_nodes[i + 1])
+                ebf.push_back(double(depth_nodes[i + 1]) / depth_nodes[i]);
+        }
+        res["depth_nodes"] = depth_list;
+        res["ebf"] = ebf;
+
+        // Время в микросекундах: генерация ходов, оценка и остальной поиск
+        res["movegen_us"] = movegen_ns / 1000;
+        res["eval_us"] = eval_ns / 1000;
+        res["search_us"] = (total_ns - movegen_ns - eval_ns) / 1000;
+        res["total_us"] = total_ns / 1000;
+        return res;
+    }
+};
+
+// Структура stats_timer добавляет время своей жизни к указанному счетчику
+struct stats_timer
+{
+    explicit stats_timer(int64_t& acc) : acc(acc), start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~stats_timer()
+    {
+        acc += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    int64_t& acc;
+    std::chrono::steady_clock::time_point start;
+};
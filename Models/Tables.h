@@ -0,0 +1,87 @@
+#pragma once
+#include <array>
+
+#include "Move.h"
+
+// Направления диагоналей в порядке перебора ходов: вверх-влево, вверх-вправо, вниз-влево, вниз-вправо
+// Белые шашки ходят вверх (направления 0 и 1), черные - вниз (2 и 3)
+constexpr POS_T DIR_X[4] = { -1, -1, 1, 1 };
+constexpr POS_T DIR_Y[4] = { -1, 1, -1, 1 };
+
+// Структура board_tables - таблицы соседства игровых клеток доски SIZE x SIZE, вычисляемые при компиляции
+// Игровые клетки нумеруются по строкам, по SIZE / 2 в строке (для 8x8 - как dark_cell)
+// Все списки содержат только клетки внутри доски, поэтому генерация ходов обходится без проверок границ
+template <int SIZE> struct board_tables
+{
+    static constexpr int CELLS = SIZE * SIZE / 2;  // Количество игровых клеток
+
+    POS_T ray[CELLS][4][SIZE - 1];  // Клетки диагонали по направлению в порядке удаления
+    POS_T ray_len[CELLS][4];        // Длина диагонали по направлению
+    POS_T step[2][CELLS][2];        // Клетки для хода шашки вперед: 0 - белые (вверх), 1 - черные (вниз)
+    POS_T step_len[2][CELLS];       // Количество таких клеток
+    POS_T jump_over[CELLS][4];      // Клетка, через которую прыгает шашка при взятии
+    POS_T jump_to[CELLS][4];        // Клетка приземления при взятии
+    POS_T jump_len[CELLS];          // Количество возможных направлений взятия
+    POS_T row[CELLS];               // Строка клетки (0 - верхняя)
+
+    // Номер игровой клетки по координатам и обратно (верхняя левая клетка доски - светлая)
+    static constexpr POS_T cell(const int x, const int y)
+    {
+        return POS_T(x * (SIZE / 2) + y / 2);
+    }
+    static constexpr POS_T cell_x(const int cell)
+    {
+        return POS_T(cell / (SIZE / 2));
+    }
+    static constexpr POS_T cell_y(const int cell)
+    {
+        return POS_T(2 * (cell % (SIZE / 2)) + 1 - (cell / (SIZE / 2)) % 2);
+    }
+};
+
+// Строит таблицы соседства для доски SIZE x SIZE
+template <int SIZE> constexpr board_tables<SIZE> make_board_tables()
+{
+    board_tables<SIZE> t{};
+    for (int cell = 0; cell < board_tables<SIZE>::CELLS; ++cell)
+    {
+        const int x = board_tables<SIZE>::cell_x(cell), y = board_tables<SIZE>::cell_y(cell);
+        t.row[cell] = POS_T(x);
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            POS_T len = 0;
+            for (int i = x + DIR_X[dir], j = y + DIR_Y[dir]; i >= 0 && i < SIZE && j >= 0 && j < SIZE;
+                 i += DIR_X[dir], j += DIR_Y[dir])
+            {
+                t.ray[cell][dir][len++] = board_tables<SIZE>::cell(i, j);
+            }
+            t.ray_len[cell][dir] = len;
+            if (len > 0)
+            {
+                const int side = dir / 2;
+                t.step[side][cell][t.step_len[side][cell]++] = t.ray[cell][dir][0];
+            }
+            if (len > 1)
+            {
+                t.jump_over[cell][t.jump_len[cell]] = t.ray[cell][dir][0];
+                t.jump_to[cell][t.jump_len[cell]++] = t.ray[cell][dir][1];
+            }
+        }
+    }
+    return t;
+}
+
+// Таблицы досок, вычисленные при компиляции (для каждого используемого размера - свои)
+template <int SIZE> inline constexpr board_tables<SIZE> BOARD_TABLES = make_board_tables<SIZE>();
+
+// Таблицы доски 8x8 для поиска бота
+inline constexpr const board_tables<8>& TABLES = BOARD_TABLES<8>;
+
+// Состояние доски для поиска: 32 игровые клетки (номера dark_cell), копируется без выделения памяти
+typedef std::array<POS_T, 32> board_t;
+
+// Цвет фигуры: true - черная (2, 4), false - белая (1, 3)
+constexpr bool piece_color(const POS_T type)
+{
+    return !(type & 1);
+}
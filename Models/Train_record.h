@@ -0,0 +1,22 @@
+#pragma once
+#include <stdint.h>
+
+// Заголовок файла обучающих позиций: сигнатура, размер записи, записи идут с 16-го байта
+static const char TRAIN_SHARD_MAGIC[8] = { 'C', 'K', 'T', 'R', 'A', 'I', 'N', '2' };
+static const uint32_t TRAIN_SHARD_HEADER = 16;
+
+// Структура train_record - обучающая позиция (24 байта, файл можно отображать в память массивом записей)
+// Позиция - четыре битовые маски по игровым клеткам (бит cell - клетка dark_cell, как в board_t)
+struct train_record
+{
+    uint32_t white_men = 0;    // Белые шашки
+    uint32_t black_men = 0;    // Черные шашки
+    uint32_t white_kings = 0;  // Белые дамки
+    uint32_t black_kings = 0;  // Черные дамки
+    int16_t score = 0;         // Оценка поиска для ходящего (Score.h: сотые доли шашки, 0 - равенство)
+    uint16_t reserved = 0;
+    uint16_t ply = 0;          // Номер хода в партии
+    uint8_t color = 0;         // Кто ходит: 0 - белые, 1 - черные
+    int8_t result = 0;         // Итог партии для ходящего: 1 - победа, 0 - ничья, -1 - поражение
+};
+static_assert(sizeof(train_record) == 24, "train_record layout is part of the shard format");
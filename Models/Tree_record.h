@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+
+// Почему узел закончил перебор ходов
+enum class tree_cut : uint8_t
+{
+    NONE,      // Просмотрены все ходы
+    CUTOFF,    // Альфа-бета отсечение после хода cut_move
+    LEAF,      // Лист: статическая оценка
+    NO_MOVES,  // Ходов нет - конец партии
+    FUTILITY,  // Отсечение futility (O2)
+    PROBCUT,   // Отсечение ProbCut (O2)
+    STOPPED,   // Поиск прерван отменой или крайним сроком
+    MATE_DISTANCE  // Выигрыш быстрее уже найденного здесь невозможен
+};
+
+// Структура tree_record - запись дампа дерева поиска (44 байта)
+// Узел записывается при выходе из него, поэтому дети идут в файле раньше родителя
+struct tree_record
+{
+    static constexpr uint32_t NO_PARENT = 0xFFFFFFFF;
+    static constexpr uint8_t NO_MOVE = 0xFF;
+
+    uint32_t search = 0;            // Номер поиска в файле
+    uint32_t id = 0;                // Номер узла в поиске (корень - 0)
+    uint32_t parent = NO_PARENT;    // Номер родителя
+    uint32_t subtree = 0;           // Узлов в поддереве, включая сам узел и незаписанных потомков
+    uint32_t wasted = 0;            // При отсечении - узлов в поддеревьях ходов до отсекшего
+    float alpha = 0, beta = 0;      // Окно при входе в узел
+    float score = 0;                // Результат узла
+    uint8_t ply = 0;                // Ходов от корня
+    int8_t remaining = 0;           // Оставшаяся глубина (с учетом сокращений)
+    uint8_t reduced = 0;            // Сокращение глубины ветки (O2)
+    tree_cut cut = tree_cut::NONE;  // Причина окончания перебора
+    uint8_t cut_move = NO_MOVE;     // Номер хода, давшего отсечение (с 0)
+    uint8_t moves = 0;              // Ходов в узле
+    uint8_t from = NO_MOVE;         // Ход, ведущий в узел (клетки dark_cell); NO_MOVE - корень или
+    uint8_t to = NO_MOVE;           // проверочный поиск ProbCut в той же позиции
+    uint8_t captures = 0;           // Взятий в ходе
+    uint8_t reserved[3] = {};
+};
+static_assert(sizeof(tree_record) == 44, "tree_record layout is part of the dump format");
@@ -0,0 +1,49 @@
+#pragma once
+
+// Когда шашка, дошедшая до последней строки во время взятия, становится дамкой
+enum class promotion_rule
+{
+    DURING_CAPTURE,  // Сразу, и продолжает бить уже как дамка (русские шашки)
+    ENDS_CAPTURE,    // Сразу, и на этом ход заканчивается (английские шашки)
+    AFTER_CAPTURE    // Только если взятие на этой строке закончилось (международные шашки)
+};
+
+// Описания вариантов правил: параметры шаблона Rules
+// Все поля - константы времени компиляции, поэтому у каждого варианта свой генератор ходов без проверок правил
+// во время игры
+
+// Русские шашки: доска 8x8, шашки бьют назад, дамки ходят на любое расстояние
+struct russian_variant
+{
+    static constexpr const char* NAME = "russian";
+    static constexpr int SIZE = 8;                 // Размер доски
+    static constexpr int MEN_ROWS = 3;             // Строк шашек в начальной расстановке
+    static constexpr bool MEN_CAPTURE_BACK = true; // Шашки бьют и назад
+    static constexpr bool FLYING_KINGS = true;     // Дамки ходят и бьют на любое расстояние
+    static constexpr promotion_rule PROMOTION = promotion_rule::DURING_CAPTURE;
+    static constexpr bool MAJORITY_CAPTURE = false;  // Обязательно взятие наибольшего числа шашек
+};
+
+// Английские шашки (checkers): шашки бьют только вперед, дамки ходят на одну клетку
+struct english_variant
+{
+    static constexpr const char* NAME = "english";
+    static constexpr int SIZE = 8;
+    static constexpr int MEN_ROWS = 3;
+    static constexpr bool MEN_CAPTURE_BACK = false;
+    static constexpr bool FLYING_KINGS = false;
+    static constexpr promotion_rule PROMOTION = promotion_rule::ENDS_CAPTURE;
+    static constexpr bool MAJORITY_CAPTURE = false;
+};
+
+// Международные шашки: доска 10x10 (50 игровых клеток), правило большинства
+struct international_variant
+{
+    static constexpr const char* NAME = "international";
+    static constexpr int SIZE = 10;
+    static constexpr int MEN_ROWS = 4;
+    static constexpr bool MEN_CAPTURE_BACK = true;
+    static constexpr bool FLYING_KINGS = true;
+    static constexpr promotion_rule PROMOTION = promotion_rule::AFTER_CAPTURE;
+    static constexpr bool MAJORITY_CAPTURE = true;
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+
+// Структура zobrist_keys - случайные ключи для хеширования позиций (хеш Зобриста)
+// Хеш позиции - XOR ключей всех фигур на своих клетках и ключа очереди хода,
+// поэтому после хода он пересчитывается несколькими операциями XOR
+struct zobrist_keys
+{
+    uint64_t piece[32][5];  // Ключ фигуры типа 1-4 на игровой клетке (тип 0 - пустая клетка, ключ 0)
+    uint64_t black_turn;    // Ключ очереди хода черных
+    uint64_t depth[64];     // Ключи глубины поиска (для кэша результатов)
+    uint64_t mode[8];       // Ключи режима оценки и оптимизации (для кэша результатов)
+};
+
+// Генератор splitmix64: детерминированные ключи, одинаковые во всех сборках
+constexpr uint64_t splitmix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+constexpr zobrist_keys make_zobrist_keys()
+{
+    zobrist_keys k{};
+    uint64_t state = 0x436865636B657273ull;  // "Checkers"
+    for (int cell = 0; cell < 32; ++cell)
+        for (int type = 1; type < 5; ++type)
+            k.piece[cell][type] = splitmix64(state);
+    k.black_turn = splitmix64(state);
+    for (int i = 0; i < 64; ++i)
+        k.depth[i] = splitmix64(state);
+    for (int i = 0; i < 8; ++i)
+        k.mode[i] = splitmix64(state);
+    return k;
+}
+
+// Ключи, вычисленные при компиляции (ключи в файлах кэша зависят от них - не менять)
+inline constexpr zobrist_keys ZOBRIST = make_zobrist_keys();
@@ -1,9 +1,108 @@
+#include <string>
+
+#include "Game/Alloc_hooks.h"
+#include "Game/Bench.h"
+#include "Game/Datagen.h"
 #include "Game/Game.h"
+#include "Game/Load_generator.h"
+#include "Game/Match.h"
+#include "Game/Perft.h"
+#include "Game/Render_batch.h"
+#include "Game/Server.h"
+#include "Game/Solver.h"
+#include "Game/Sprt.h"
+#include "Game/Tree_summary.h"
 
 int main(int argc, char* argv[])
 {
+    // Режим бенчмарка: Checkers bench [alloc], повтор медленного поиска: Checkers bench <файл>
+    if (argc > 1 && string(argv[1]) == "bench")
+    {
+        if (argc > 2 && string(argv[2]) != "alloc")
+            return Bench::replay(argv[2]);
+        return Bench(argc > 2 && string(argv[2]) == "alloc").run();
+    }
+
+    // Матч двух настроек поиска:
+    // Checkers match <optimization A> <level A> <optimization B> <level B> [games] [alloc]
+    if (argc > 5 && string(argv[1]) == "match")
+    {
+        const bool alloc = string(argv[argc - 1]) == "alloc";
+        const int games = argc > 6 && string(argv[6]) != "alloc" ? stoi(argv[6]) : 100;
+        return Match({ argv[2], stoi(argv[3]) }, { argv[4], stoi(argv[5]) }, games, alloc).run();
+    }
+
+    // Генерация обучающих позиций (раздел "DataGen" в settings.json): Checkers datagen <games>
+    if (argc > 2 && string(argv[1]) == "datagen")
+        return Datagen(stoi(argv[2])).run();
+
+    // A/B-проверка настроек поиска до решения SPRT (раздел "SPRT" в settings.json):
+    // Checkers sprt <optimization A> <level A> <optimization B> <level B>
+    if (argc > 5 && string(argv[1]) == "sprt")
+        return Sprt({ argv[2], stoi(argv[3]) }, { argv[4], stoi(argv[5]) }).run();
+
+    // Проверка генератора ходов варианта правил: Checkers perft <russian|english|international> [depth]
+    if (argc > 2 && string(argv[1]) == "perft")
+        return Perft(argv[2], argc > 3 ? stoi(argv[3]) : 6).run();
+
+    // Сводка по дампу дерева поиска (настройка TreeDump): Checkers tree <file> [top]
+    if (argc > 2 && string(argv[1]) == "tree")
+        return Tree_summary(argv[2], argc > 3 ? stoi(argv[3]) : 10).run();
+
+    // Точное решение позиции: Checkers solve <position> <w|b> [turn]
+    if (argc > 3 && string(argv[1]) == "solve")
+    {
+        const bool color = string(argv[3]) == "b";
+        const int res = Solver().run(argv[2], color, argc > 4 ? stoi(argv[4]) : int(color));
+        Logger::get().stop();
+        return res;
+    }
+
+    // Пакетная отрисовка позиций и партий в PNG без окна: Checkers render <input> <out_dir> [sheet]
+    if (argc > 3 && string(argv[1]) == "render")
+    {
+        const int res = Render_batch(argv[2], argv[3], argc > 4 && string(argv[4]) == "sheet").run();
+        Logger::get().stop();
+        return res;
+    }
+
+    // Сервер партий и генератор нагрузки для него:
+    // Checkers server, Checkers loadgen [clients] [sessions] [games] [level]
+    if (argc > 1 && (string(argv[1]) == "server" || string(argv[1]) == "loadgen"))
+    {
+#ifndef _WIN32
+        if (string(argv[1]) == "server")
+            return Server().run();
+        auto arg = [&](const int i, const int def) { return argc > i ? stoi(argv[i]) : def; };
+        return Load_generator(arg(2, 4), arg(3, 16), arg(4, 64), arg(5, 3)).run();
+#else
+        cerr << "Server mode is not supported on Windows" << endl;
+        return 1;
+#endif
+    }
+
+    // Запись ввода и воспроизведение с замером задержки от клика до кадра:
+    // Checkers record <file>, Checkers playback <file> (без экрана - с видеодрайвером SDL "dummy")
+    if (argc > 2 && (string(argv[1]) == "record" || string(argv[1]) == "playback"))
+    {
+        const bool is_record = string(argv[1]) == "record";
+        if (!is_record)
+            SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);  // Заданный в окружении драйвер не меняем
+        if (is_record ? !Input_log::get().start_record(argv[2]) : !Input_log::get().start_playback(argv[2]))
+        {
+            cerr << "Can't open input log " << argv[2] << endl;
+            return 1;
+        }
+    }
+
     Game g;
     g.play();
+    if (Input_log::get().is_recording() || Input_log::get().is_playback())
+        Input_log::get().report();
+
+    // Дописываем все сообщения журнала и трассировку до выхода
+    Logger::get().stop();
+    Tracer::get().write();
 
     return 0;
 }